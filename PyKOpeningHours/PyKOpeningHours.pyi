@@ -1,7 +1,7 @@
 # SPDX-FileCopyrightText: 2020 David Faure <faure@kde.org>
 # SPDX-License-Identifier: LGPL-2.0-or-later
 
-from typing import Any
+from typing import Any, Optional, Sequence, Tuple, List
 
 class Error():
     EvaluationError: Any = ...
@@ -21,7 +21,18 @@ class Mode():
     names: Any = ...
     values: Any = ...
 
+class State():
+    Closed: Any = ...
+    Invalid: Any = ...
+    Open: Any = ...
+    Unknown: Any = ...
+    names: Any = ...
+    values: Any = ...
+
 class OpeningHours():
     def error(self) -> Error: ...
     def normalizedExpression(self) -> str: ...
     def setExpression(self, str) -> None: ...
+
+def validateMany(expressions: Sequence[str], modes: Mode = ...) -> Tuple[List[Error], List[str]]: ...
+def evaluateMany(expressions: Sequence[str], timestamp: float, regions: Optional[Sequence[str]] = ..., latitudes: Optional[Sequence[float]] = ..., longitudes: Optional[Sequence[float]] = ..., timeZones: Optional[Sequence[str]] = ...) -> Tuple[List[Error], List[State]]: ...
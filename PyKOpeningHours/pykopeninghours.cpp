@@ -4,14 +4,189 @@
     SPDX-License-Identifier: LGPL-2.0-or-later
 */
 #include <boost/python/class.hpp>
+#include <boost/python/def.hpp>
+#include <boost/python/extract.hpp>
+#include <boost/python/list.hpp>
 #include <boost/python/module.hpp>
 #include <boost/python/enum.hpp>
+#include <boost/python/tuple.hpp>
 #include "python_qt_wrappers.h"
+#include <KOpeningHours/ExpressionCache>
 #include <KOpeningHours/OpeningHours>
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+#include <KOpeningHours/Interval>
+#endif
+
+#include <QDateTime>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QTimeZone>
+
+#include <algorithm>
+#include <vector>
 
 using namespace boost::python;
 using namespace KOpeningHours;
 
+namespace {
+/** Releases the GIL for the lifetime of this object. */
+class GilReleaser
+{
+public:
+    GilReleaser() : m_state(PyEval_SaveThread()) {}
+    ~GilReleaser() { PyEval_RestoreThread(m_state); }
+private:
+    PyThreadState *m_state;
+};
+
+template <typename F>
+class ChunkJob : public QRunnable
+{
+public:
+    ChunkJob(const F &f, std::size_t begin, std::size_t end, QSemaphore *done)
+        : m_f(f), m_begin(begin), m_end(end), m_done(done)
+    {
+        setAutoDelete(true);
+    }
+    void run() override
+    {
+        m_f(m_begin, m_end);
+        m_done->release();
+    }
+private:
+    const F &m_f;
+    std::size_t m_begin;
+    std::size_t m_end;
+    QSemaphore *m_done;
+};
+
+/** Calls @p f(begin, end) for chunks of [0, count) on the global thread pool, and waits for all of them. */
+template <typename F>
+void parallelFor(std::size_t count, const F &f)
+{
+    enum { MinimumChunkSize = 1024 };
+    const auto pool = QThreadPool::globalInstance();
+    const auto chunkCount = std::max<std::size_t>(1, std::min<std::size_t>(std::max(pool->maxThreadCount(), 1) * 4, count / MinimumChunkSize));
+    const auto chunkSize = (count + chunkCount - 1) / chunkCount;
+    QSemaphore done;
+    int jobs = 0;
+    for (std::size_t begin = 0; begin < count; begin += chunkSize) {
+        pool->start(new ChunkJob<F>(f, begin, std::min(count, begin + chunkSize), &done));
+        ++jobs;
+    }
+    done.acquire(jobs);
+}
+
+/** Converts any Python sequence of strings (list, tuple, NumPy array, ...). */
+std::vector<QByteArray> toByteArrays(const object &seq)
+{
+    std::vector<QByteArray> result;
+    const auto size = len(seq);
+    result.reserve(size);
+    for (decltype(len(seq)) i = 0; i < size; ++i) {
+        result.push_back(extract<QByteArray>(seq[i]));
+    }
+    return result;
+}
+
+/** Validates all @p expressions, returns a tuple of a list of error codes and a list of normalized expressions. */
+tuple validateMany(const object &expressions, OpeningHours::Modes modes)
+{
+    const auto input = toByteArrays(expressions);
+    std::vector<OpeningHours::Error> errors(input.size());
+    std::vector<QByteArray> normalized(input.size());
+    {
+        GilReleaser releaser;
+        parallelFor(input.size(), [&](std::size_t begin, std::size_t end) {
+            OpeningHours oh;
+            for (auto i = begin; i < end; ++i) {
+                oh.setExpression(input[i], modes);
+                errors[i] = oh.error();
+                if (errors[i] != OpeningHours::SyntaxError) {
+                    normalized[i] = oh.normalizedExpression();
+                }
+            }
+        });
+    }
+
+    list errorList, normalizedList;
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        errorList.append(errors[i]);
+        normalizedList.append(normalized[i]);
+    }
+    return make_tuple(errorList, normalizedList);
+}
+
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+/** Optional per-expression column, either None or a sequence with one element per expression. */
+template <typename T>
+std::vector<T> optionalColumn(const object &column, std::size_t size)
+{
+    std::vector<T> result;
+    if (column.is_none()) {
+        return result;
+    }
+    if (static_cast<std::size_t>(len(column)) != size) {
+        PyErr_SetString(PyExc_ValueError, "column size doesn't match number of expressions");
+        throw_error_already_set();
+    }
+    result.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        result.push_back(extract<T>(column[i]));
+    }
+    return result;
+}
+
+/** Evaluates all @p expressions at @p timestamp (seconds since the Unix epoch).
+ *  Returns a tuple of a list of error codes and a list of interval states.
+ */
+tuple evaluateMany(const object &expressions, double timestamp, const object &regions, const object &latitudes, const object &longitudes, const object &timeZones)
+{
+    const auto input = toByteArrays(expressions);
+    const auto regionColumn = optionalColumn<QByteArray>(regions, input.size());
+    const auto latitudeColumn = optionalColumn<double>(latitudes, input.size());
+    const auto longitudeColumn = optionalColumn<double>(longitudes, input.size());
+    const auto timeZoneColumn = optionalColumn<QByteArray>(timeZones, input.size());
+    const auto dt = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(timestamp * 1000.0));
+
+    std::vector<OpeningHours::Error> errors(input.size());
+    std::vector<Interval::State> states(input.size(), Interval::Invalid);
+    {
+        GilReleaser releaser;
+        // columns typically contain the same few expressions many times
+        ExpressionCache cache;
+        parallelFor(input.size(), [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                auto oh = cache.get(input[i]);
+                if (!regionColumn.empty()) {
+                    oh.setRegion(QString::fromUtf8(regionColumn[i]));
+                }
+                if (!latitudeColumn.empty() && !longitudeColumn.empty()) {
+                    oh.setLocation(static_cast<float>(latitudeColumn[i]), static_cast<float>(longitudeColumn[i]));
+                }
+                if (!timeZoneColumn.empty()) {
+                    oh.setTimeZone(QTimeZone(timeZoneColumn[i]));
+                }
+                errors[i] = oh.error();
+                if (errors[i] == OpeningHours::NoError) {
+                    // evaluation uses the wall clock time of its argument, which has to be that of the expression's time zone
+                    states[i] = oh.interval(dt.toTimeZone(oh.timeZone())).state();
+                }
+            }
+        });
+    }
+
+    list errorList, stateList;
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        errorList.append(errors[i]);
+        stateList.append(states[i]);
+    }
+    return make_tuple(errorList, stateList);
+}
+#endif
+}
+
 BOOST_PYTHON_MODULE(PyKOpeningHours)
 {
     register_qt_wrappers();
@@ -39,4 +214,20 @@ BOOST_PYTHON_MODULE(PyKOpeningHours)
             .value("UnsupportedFeature", OpeningHours::UnsupportedFeature) ///< expression uses a feature that isn't implemented/supported (yet)
             .value("EvaluationError", OpeningHours::EvaluationError) ///< runtime error during evaluating the expression
             ;
+
+    // bulk functions, these run on multiple threads without holding the GIL
+    def("validateMany", validateMany,
+        (arg("expressions"), arg("modes")=OpeningHours::Modes{OpeningHours::IntervalMode}));
+
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+    enum_<Interval::State>("State")
+            .value("Invalid", Interval::Invalid)
+            .value("Open", Interval::Open)
+            .value("Closed", Interval::Closed)
+            .value("Unknown", Interval::Unknown)
+            ;
+
+    def("evaluateMany", evaluateMany,
+        (arg("expressions"), arg("timestamp"), arg("regions")=object(), arg("latitudes")=object(), arg("longitudes")=object(), arg("timeZones")=object()));
+#endif
 }
@@ -10,3 +10,66 @@ if parser.error() != PyKOpeningHours.Error.NoError:
     print("ERROR parsing expression:" + str(parser.error()))
 else:
     print(parser.normalizedExpression())
+
+Error = PyKOpeningHours.Error
+
+def validate(expression):
+    oh = PyKOpeningHours.OpeningHours()
+    oh.setExpression(expression)
+    return oh.error(), oh.normalizedExpression() if oh.error() != Error.SyntaxError else ''
+
+# bulk validation has to give the same results as validating one expression at a time
+expressions = ['Mo-Fr 08:00-18:00', 'Mo-Fr 8-18', 'not an expression', '', 'PH off', 'sunrise-sunset', 'Mo-Fr 08:00-18:00; Sa 10:00-14:00']
+for exprs in (expressions, expressions * 1000): # the latter is split into several chunks
+    errors, normalized = PyKOpeningHours.validateMany(exprs)
+    assert len(errors) == len(exprs) and len(normalized) == len(exprs)
+    for expr, error, norm in zip(exprs, errors, normalized):
+        assert (error, norm) == validate(expr), (expr, error, norm)
+
+errors, normalized = PyKOpeningHours.validateMany(expressions)
+assert errors[0] == Error.NoError and normalized[0] == 'Mo-Fr 08:00-18:00'
+assert errors[1] == Error.NoError and normalized[1] == 'Mo-Fr 08:00-18:00'
+assert errors[2] == Error.SyntaxError and normalized[2] == ''
+assert errors[3] == Error.Null
+
+if hasattr(PyKOpeningHours, 'evaluateMany'):
+    State = PyKOpeningHours.State
+    timestamp = 1702900800 # Monday, 2023-12-18 12:00 UTC
+    cases = [
+        ('24/7', Error.NoError, State.Open),
+        ('off', Error.NoError, State.Closed),
+        ('Mo-Fr 08:00-18:00', Error.NoError, State.Open),
+        ('Sa-Su 10:00-12:00', Error.NoError, State.Closed),
+        ('Mo 10:00-14:00 unknown', Error.NoError, State.Unknown),
+        ('not an expression', Error.SyntaxError, State.Invalid),
+        ('PH off', Error.MissingRegion, State.Invalid),
+        ('sunrise-sunset', Error.MissingLocation, State.Invalid),
+    ]
+    for repeat in (1, 1000):
+        exprs = [c[0] for c in cases] * repeat
+        errors, states = PyKOpeningHours.evaluateMany(exprs, timestamp, timeZones=['UTC'] * len(exprs))
+        assert len(errors) == len(exprs) and len(states) == len(exprs)
+        for i, (error, state) in enumerate(zip(errors, states)):
+            expr, expectedError, expectedState = cases[i % len(cases)]
+            assert error == expectedError and error == validate(expr)[0], (expr, error)
+            assert state == expectedState, (expr, state)
+
+    # per-expression context columns
+    errors, states = PyKOpeningHours.evaluateMany(['PH off', 'Mo-Fr 08:00-18:00; PH off', 'sunrise-sunset'], timestamp,
+                                                  regions=['DE', 'DE', 'DE'], latitudes=[52.5, 52.5, 52.5], longitudes=[13.4, 13.4, 13.4],
+                                                  timeZones=['Europe/Berlin'] * 3)
+    assert errors == [Error.NoError] * 3, errors
+    assert states == [State.Closed, State.Open, State.Open], states
+
+    # rows are evaluated at the local time of their time zone
+    errors, states = PyKOpeningHours.evaluateMany(['Mo-Fr 08:00-18:00'] * 3, timestamp, timeZones=['UTC', 'Asia/Tokyo', 'America/New_York'])
+    assert errors == [Error.NoError] * 3, errors
+    assert states == [State.Open, State.Closed, State.Closed], states # 12:00, 21:00, 07:00
+
+    try:
+        PyKOpeningHours.evaluateMany(['24/7', 'off'], timestamp, regions=['DE'])
+        assert False, 'mismatching column size not rejected'
+    except ValueError:
+        pass
+
+print('OK')
@@ -0,0 +1,73 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KOpeningHours/BatchEvaluator>
+#include <KOpeningHours/Interval>
+#include <KOpeningHours/OpeningHours>
+
+#include <QTest>
+
+#include <iterator>
+
+using namespace KOpeningHours;
+
+void initLocale()
+{
+    qputenv("TZ", "Europe/Berlin");
+}
+
+Q_CONSTRUCTOR_FUNCTION(initLocale)
+
+class BatchEvaluatorTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testEvaluate_data()
+    {
+        QTest::addColumn<int>("count");
+        QTest::addColumn<bool>("parallel");
+
+        QTest::newRow("empty") << 0 << false;
+        QTest::newRow("sequential") << 100 << false;
+        QTest::newRow("parallel small") << 100 << true;
+        QTest::newRow("parallel") << 5000 << true;
+    }
+
+    void testEvaluate()
+    {
+        QFETCH(int, count);
+        QFETCH(bool, parallel);
+
+        const char *exprs[] = { "Mo-Fr 08:00-18:00", "Mo-Sa 10:00-20:00; Tu off", "24/7", "Sa-Su open || \"with appointment\"",
+                                "Mo-Fr 08:00-12:00,13:00-17:30; PH off", "sunrise-sunset", "this is not an expression" };
+        std::vector<OpeningHours> expressions;
+        for (int i = 0; i < count; ++i) {
+            OpeningHours oh(exprs[i % std::size(exprs)]);
+            oh.setLocation(52.5, 13.0);
+            oh.setRegion(QStringLiteral("DE"));
+            expressions.push_back(oh);
+        }
+        const QDateTime dt({2020, 11, 7}, {18, 0});
+        const auto results = BatchEvaluator::evaluate(expressions, dt, parallel ? BatchEvaluator::Parallel : BatchEvaluator::Sequential);
+        QCOMPARE(results.size(), expressions.size());
+
+        for (std::size_t i = 0; i < expressions.size(); ++i) {
+            const auto &oh = expressions[i];
+            if (oh.error() != OpeningHours::NoError) {
+                QCOMPARE(results[i].state, Interval::Invalid);
+                QVERIFY(!results[i].nextChange.isValid());
+                continue;
+            }
+            const auto interval = oh.interval(dt);
+            QCOMPARE(results[i].state, interval.state());
+            QCOMPARE(results[i].nextChange, interval.end());
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(BatchEvaluatorTest)
+
+#include "batchevaluatortest.moc"
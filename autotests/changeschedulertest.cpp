@@ -0,0 +1,140 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KOpeningHours/ChangeScheduler>
+#include <KOpeningHours/Interval>
+#include <KOpeningHours/OpeningHours>
+
+#include <QTest>
+
+#include <algorithm>
+
+using namespace KOpeningHours;
+
+void initLocale()
+{
+    qputenv("TZ", "Europe/Berlin");
+}
+
+Q_CONSTRUCTOR_FUNCTION(initLocale)
+
+class ChangeSchedulerTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testUpdate()
+    {
+        const char *exprs[] = { "Mo-Fr 08:00-18:00", "24/7", "off", "Mo-Fr 08:00-12:00,13:00-17:45; Sa 10:00-14:00",
+                                "sunrise-sunset", "Mo-Fr 09:00-18:00; PH off", "Mo-Su 18:00-02:00", "23/7",
+                                "Mo-Fr 10:00-20:00; Sa 10:00-20:00 \"reduced service\"", "Mo 08:00-18:00 unknown" };
+        const QDateTime begin({2023, 12, 20}, {9, 13});
+        std::vector<OpeningHours> ohs;
+        ChangeScheduler scheduler;
+        for (const auto expr : exprs) {
+            OpeningHours oh(expr);
+            oh.setLocation(52.5, 13.4);
+            oh.setRegion(QStringLiteral("DE"));
+            ohs.push_back(oh);
+            scheduler.insert(ohs.size(), oh, begin);
+        }
+        QCOMPARE(scheduler.size(), ohs.size());
+        QVERIFY(scheduler.contains(1));
+        QVERIFY(!scheduler.contains(0));
+        QCOMPARE(scheduler.state(0), Interval::Invalid);
+        QCOMPARE(scheduler.state(1), Interval::Open);
+        QCOMPARE(scheduler.state(2), Interval::Open);
+        QCOMPARE(scheduler.state(3), Interval::Closed);
+        QCOMPARE(scheduler.state(7), Interval::Closed);
+        QVERIFY(!scheduler.interval(8).isValid());
+        QCOMPARE(scheduler.nextChange(), QDateTime({2023, 12, 20}, {10, 0}));
+
+        std::vector<Interval> current;
+        for (std::size_t i = 0; i < ohs.size(); ++i) {
+            current.push_back(scheduler.interval(i + 1));
+        }
+
+        int signalCount = 0;
+        std::vector<ChangeScheduler::Id> changed;
+        connect(&scheduler, &ChangeScheduler::changed, this, [&](const std::vector<ChangeScheduler::Id> &ids) {
+            ++signalCount;
+            changed = ids;
+            std::sort(changed.begin(), changed.end());
+        });
+
+        // going forward, including the Christmas holidays, and then back again
+        std::vector<QDateTime> times;
+        for (auto dt = begin; dt < begin.addDays(8); dt = dt.addSecs(17 * 60)) {
+            times.push_back(dt);
+        }
+        times.push_back(begin.addDays(1));
+        times.push_back(begin);
+
+        for (const auto &dt : times) {
+            QDateTime expectedNextChange;
+            std::vector<ChangeScheduler::Id> expected;
+            scheduler.update(dt);
+            for (std::size_t i = 0; i < ohs.size(); ++i) {
+                if (ohs[i].error() != OpeningHours::NoError) {
+                    QCOMPARE(scheduler.state(i + 1), Interval::Invalid);
+                    continue;
+                }
+                const auto interval = ohs[i].interval(dt);
+                QCOMPARE(scheduler.state(i + 1), interval.state());
+                QCOMPARE(scheduler.interval(i + 1).end(), interval.end());
+                if (interval.state() != current[i].state() || interval.comment() != current[i].comment()) {
+                    expected.push_back(i + 1);
+                }
+                current[i] = interval;
+                if (!interval.hasOpenEnd() && interval.end().isValid() && (!expectedNextChange.isValid() || interval.end() < expectedNextChange)) {
+                    expectedNextChange = interval.end();
+                }
+            }
+            QCOMPARE(scheduler.nextChange(), expectedNextChange);
+
+            QCOMPARE(signalCount, expected.empty() ? 0 : 1);
+            QCOMPARE(changed, expected);
+            signalCount = 0;
+            changed.clear();
+        }
+    }
+
+    void testModify()
+    {
+        const QDateTime dt({2023, 12, 22}, {10, 30});
+        ChangeScheduler scheduler;
+        scheduler.insert(1, OpeningHours("24/7"), dt);
+        QVERIFY(!scheduler.nextChange().isValid());
+        scheduler.insert(2, OpeningHours("Mo-Su 00:00-11:59,12:00-23:59"), dt);
+        QCOMPARE(scheduler.nextChange(), QDateTime({2023, 12, 22}, {11, 59}));
+        QCOMPARE(scheduler.state(2), Interval::Open);
+
+        // many updates, which triggers removal of outdated data
+        const OpeningHours oh("Mo-Su 00:00-05:59,06:00-10:44,10:45-17:59,18:00-23:59");
+        for (int i = 0; i < 2000; ++i) {
+            scheduler.insert(3, oh, dt);
+        }
+        QCOMPARE(scheduler.size(), std::size_t(3));
+        QCOMPARE(scheduler.nextChange(), QDateTime({2023, 12, 22}, {10, 44}));
+
+        scheduler.remove(3);
+        scheduler.remove(4);
+        QVERIFY(!scheduler.contains(3));
+        QCOMPARE(scheduler.state(3), Interval::Invalid);
+        QCOMPARE(scheduler.nextChange(), QDateTime({2023, 12, 22}, {11, 59}));
+
+        scheduler.insert(2, OpeningHours("off"), dt);
+        QVERIFY(!scheduler.nextChange().isValid());
+        QCOMPARE(scheduler.state(2), Interval::Closed);
+
+        scheduler.clear();
+        QCOMPARE(scheduler.size(), std::size_t(0));
+        QVERIFY(!scheduler.contains(1));
+    }
+};
+
+QTEST_GUILESS_MAIN(ChangeSchedulerTest)
+
+#include "changeschedulertest.moc"
@@ -4,10 +4,18 @@
     SPDX-License-Identifier: LGPL-2.0-or-later
 */
 
+#include <KOpeningHours/Display>
 #include <KOpeningHours/Interval>
 #include <KOpeningHours/OpeningHours>
 
+#include <QFutureWatcher>
+#include <QSignalSpy>
 #include <QTest>
+#include <QThread>
+#include <QTimeZone>
+
+#include <memory>
+#include <vector>
 
 using namespace KOpeningHours;
 
@@ -168,6 +176,8 @@ private Q_SLOTS:
         QTest::newRow("nth day month end") << QByteArray("Oct Su[1]-Nov Su[-4] 09:00-12:00") << QDateTime({2020, 11, 8}, {9, 0}) << QDateTime({2020, 11, 8}, {12, 0});
         QTest::newRow("nth day only end") << QByteArray("Oct 1-Nov Su[-4] 09:00-12:00") << QDateTime({2020, 11, 8}, {9, 0}) << QDateTime({2020, 11, 8}, {12, 0});
         QTest::newRow("nth day only end with weekday") << QByteArray("Oct 1-Nov Su[-4] Mo 09:00-12:00") << QDateTime({2020, 11, 9}, {9, 0}) << QDateTime({2020, 11, 9}, {12, 0});
+        QTest::newRow("sparse week and nth day") << QByteArray("week 01-53/4 Mo[1] 10:00-12:00") << QDateTime({2021, 1, 4}, {10, 0}) << QDateTime({2021, 1, 4}, {12, 0});
+        QTest::newRow("sparse monthday and weekday") << QByteArray("Jan 1 Mo 10:00-12:00") << QDateTime({2024, 1, 1}, {10, 0}) << QDateTime({2024, 1, 1}, {12, 0});
     }
 
     void testNext()
@@ -312,6 +322,31 @@ private Q_SLOTS:
         QCOMPARE(i.comment(), QLatin1String("on appointment"));
     }
 
+    void testComments()
+    {
+        OpeningHours oh("Mo-Fr 08:00-12:00 \"morning\"; Mo-Fr 14:00-18:00 \"afternoon\"; Sa 10:00-12:00 \"morning\"");
+        QCOMPARE(oh.error(), OpeningHours::NoError);
+        const auto intervals = oh.intervals(QDateTime({2020, 11, 6}, {0, 0}), QDateTime({2020, 11, 8}, {0, 0}));
+        QStringList comments;
+        for (const auto &i : intervals) {
+            if (i.state() == Interval::Open) {
+                comments.push_back(i.comment());
+            }
+        }
+        QCOMPARE(comments, QStringList({QStringLiteral("morning"), QStringLiteral("afternoon"), QStringLiteral("morning")}));
+
+        // explicitly set comments replace the evaluated ones, without affecting other copies
+        const auto evaluated = oh.interval(QDateTime({2020, 11, 6}, {9, 0}));
+        auto i = evaluated;
+        i.setComment(QStringLiteral("changed"));
+        QCOMPARE(i.comment(), QLatin1String("changed"));
+        QCOMPARE(evaluated.comment(), QLatin1String("morning"));
+
+        // same comment from a different expression
+        OpeningHours oh2("Mo-Su 10:00-11:00 \"morning\"");
+        QCOMPARE(oh2.interval(QDateTime({2020, 11, 6}, {10, 30})).comment(), QLatin1String("morning"));
+    }
+
     void testLookBack()
     {
         OpeningHours oh("Oct-Mar");
@@ -320,6 +355,200 @@ private Q_SLOTS:
         QVERIFY(i.isValid());
         QCOMPARE(i.state(), Interval::Open);
     }
+
+    void testConcurrentEvaluation()
+    {
+        OpeningHours oh("Mo-Fr 08:00-18:00; PH off");
+        oh.setRegion(QStringLiteral("DE-BW"));
+        QCOMPARE(oh.error(), OpeningHours::NoError);
+
+        const auto evaluate = [&oh]() {
+            QByteArray result;
+            auto i = oh.interval(QDateTime({2020, 11, 7}, {18, 0}));
+            for (int n = 0; i.isValid() && n < 1000; ++n) {
+                result += i.begin().toString(Qt::ISODate).toUtf8() + ' ' + QByteArray::number(i.state()) + ' ' + i.comment().toUtf8() + '\n';
+                i = oh.nextInterval(i);
+            }
+            return result;
+        };
+
+        std::vector<QByteArray> results(8);
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (auto &result : results) {
+            threads.emplace_back(QThread::create([&result, &evaluate]() { result = evaluate(); }));
+            threads.back()->start();
+        }
+        for (const auto &thread : threads) {
+            QVERIFY(thread->wait());
+        }
+
+        QCOMPARE(oh.error(), OpeningHours::NoError);
+        const auto reference = evaluate();
+        QVERIFY(!reference.isEmpty());
+        for (const auto &result : results) {
+            QCOMPARE(result, reference);
+        }
+    }
+
+    void testPrecompute_data()
+    {
+        QTest::addColumn<QByteArray>("expression");
+        QTest::newRow("weekly") << QByteArray("Mo-Fr 08:00-12:00,13:00-17:30; Sa 08:00-12:00");
+        QTest::newRow("holidays") << QByteArray("Mo-Fr 08:00-18:00; PH off");
+        QTest::newRow("sun") << QByteArray("sunrise-sunset");
+        QTest::newRow("past") << QByteArray("2020 Nov 1-2020 Nov 20");
+        QTest::newRow("24/7") << QByteArray("24/7");
+    }
+
+    void testPrecompute()
+    {
+        QFETCH(QByteArray, expression);
+
+        OpeningHours oh(expression);
+        oh.setLocation(52.5, 13.0);
+        oh.setRegion(QStringLiteral("DE-BW"));
+        QCOMPARE(oh.error(), OpeningHours::NoError);
+        OpeningHours ref(expression);
+        ref.setLocation(52.5, 13.0);
+        ref.setRegion(QStringLiteral("DE-BW"));
+
+        oh.precompute({2020, 11, 1}, {2020, 12, 1});
+        // covers the precomputed range, its lazy extension, and times outside of both
+        for (auto dt = QDateTime({2020, 10, 25}, {0, 0}); dt < QDateTime({2021, 2, 1}, {0, 0}); dt = dt.addSecs(37 * 60)) {
+            const auto i = oh.interval(dt);
+            const auto j = ref.interval(dt);
+            QCOMPARE(i.isValid(), j.isValid());
+            if (!j.isValid()) {
+                continue;
+            }
+            QVERIFY(i.contains(dt));
+            QCOMPARE(i.state(), j.state());
+        }
+
+        // changing parameters discards precomputed results
+        oh.setTimeZone(QTimeZone("Europe/London"));
+        ref.setTimeZone(QTimeZone("Europe/London"));
+        const QDateTime dt({2020, 11, 7}, {18, 0});
+        QCOMPARE(oh.interval(dt).begin(), ref.interval(dt).begin());
+        QCOMPARE(oh.interval(dt).end(), ref.interval(dt).end());
+    }
+
+    void testIntervals_data()
+    {
+        testPrecompute_data();
+    }
+
+    void testIntervals()
+    {
+        QFETCH(QByteArray, expression);
+
+        OpeningHours oh(expression);
+        oh.setLocation(52.5, 13.0);
+        oh.setRegion(QStringLiteral("DE-BW"));
+        QCOMPARE(oh.error(), OpeningHours::NoError);
+
+        const QDateTime from({2020, 11, 3}, {9, 17});
+        const QDateTime to({2020, 12, 24}, {0, 0});
+        std::vector<Interval> expected;
+        for (auto i = oh.interval(from); i.isValid(); i = oh.nextInterval(i)) {
+            expected.push_back(i);
+            if (i.hasOpenEnd() || i.end() >= to) {
+                break;
+            }
+        }
+        QVERIFY(!expected.empty());
+
+        const auto verify = [&expected](const std::vector<Interval> &result) {
+            QCOMPARE(result.size(), expected.size());
+            for (std::size_t i = 0; i < result.size(); ++i) {
+                QCOMPARE(result[i].begin(), expected[i].begin());
+                QCOMPARE(result[i].end(), expected[i].end());
+                QCOMPARE(result[i].state(), expected[i].state());
+                QCOMPARE(result[i].comment(), expected[i].comment());
+            }
+        };
+        verify(oh.intervals(from, to));
+
+        // partially and fully covered by precomputed results
+        oh.precompute({2020, 11, 1}, {2020, 11, 20});
+        verify(oh.intervals(from, to));
+        oh.precompute({2020, 11, 1}, {2021, 1, 1});
+        std::vector<Interval> result;
+        oh.intervals(from, to, result);
+        verify(result);
+
+        QVERIFY(oh.intervals(to, from).empty());
+    }
+
+    void testAsync()
+    {
+        OpeningHours oh("Mo-Fr 08:00-18:00; PH off");
+        oh.setRegion(QStringLiteral("DE"));
+        QCOMPARE(oh.error(), OpeningHours::NoError);
+
+        const QDateTime dt({2020, 12, 25}, {12, 0});
+        auto future = oh.intervalAsync(dt);
+        future.waitForFinished();
+        const auto i = future.result();
+        QCOMPARE(i.state(), Interval::Closed);
+        QCOMPARE(i.begin(), oh.interval(dt).begin());
+        QCOMPARE(i.end(), oh.interval(dt).end());
+
+        QFutureWatcher<QString> watcher;
+        QSignalSpy spy(&watcher, &QFutureWatcher<QString>::finished);
+        watcher.setFuture(Display::currentStateAsync(OpeningHours("24/7")));
+        QVERIFY(watcher.isFinished() || spy.wait());
+        QCOMPARE(watcher.result(), Display::currentState(OpeningHours("24/7")));
+    }
+
+    void testExpiredRules()
+    {
+        // rules that ended long ago don't change anything
+        OpeningHours oh("Mo-Fr 08:00-18:00; 2019 Dec 24 off; 2019 Dec 31 20:00-02:00; 2018-2019 Sa 10:00-12:00; 2020 Nov 6-2020 Dec 13 Su 10:00-12:00");
+        QCOMPARE(oh.error(), OpeningHours::NoError);
+        OpeningHours ref("Mo-Fr 08:00-18:00");
+        auto i = oh.interval(QDateTime({2023, 1, 1}, {0, 0}));
+        auto j = ref.interval(QDateTime({2023, 1, 1}, {0, 0}));
+        for (int n = 0; n < 50; ++n) {
+            QCOMPARE(i.begin(), j.begin());
+            QCOMPARE(i.end(), j.end());
+            QCOMPARE(i.state(), j.state());
+            i = oh.nextInterval(i);
+            j = ref.nextInterval(j);
+        }
+
+        // but still apply around their end
+        QCOMPARE(oh.interval(QDateTime({2019, 12, 24}, {10, 0})).state(), Interval::Closed);
+        QCOMPARE(oh.interval(QDateTime({2019, 12, 28}, {11, 0})).state(), Interval::Open);
+        QCOMPARE(oh.interval(QDateTime({2020, 1, 1}, {1, 0})).state(), Interval::Open);
+        QCOMPARE(oh.interval(QDateTime({2020, 12, 13}, {11, 0})).state(), Interval::Open);
+        QCOMPARE(oh.interval(QDateTime({2020, 12, 20}, {11, 0})).state(), Interval::Closed);
+    }
+
+    void testSunEventInvalidation()
+    {
+        OpeningHours oh("sunrise-sunset");
+        oh.setLocation(52.5, 13.0);
+        const QDateTime dt({2020, 11, 7}, {12, 0});
+        const auto berlin = oh.interval(dt);
+        QVERIFY(berlin.isValid());
+        // memoized results
+        QCOMPARE(oh.interval(dt).begin(), berlin.begin());
+        QCOMPARE(oh.interval(dt.addDays(1)).begin().date(), dt.addDays(1).date());
+
+        // changing the location or time zone discards memoized sun events
+        oh.setLocation(48.1, 11.6);
+        OpeningHours ref("sunrise-sunset");
+        ref.setLocation(48.1, 11.6);
+        QCOMPARE(oh.interval(dt).begin(), ref.interval(dt).begin());
+        QCOMPARE(oh.interval(dt).end(), ref.interval(dt).end());
+        QVERIFY(oh.interval(dt).begin() != berlin.begin());
+
+        oh.setTimeZone(QTimeZone("Europe/London"));
+        ref.setTimeZone(QTimeZone("Europe/London"));
+        QCOMPARE(oh.interval(dt).begin(), ref.interval(dt).begin());
+        QCOMPARE(oh.interval(dt).end(), ref.interval(dt).end());
+    }
 };
 
 QTEST_GUILESS_MAIN(EvaluateTest)
@@ -0,0 +1,120 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KOpeningHours/ExpressionCache>
+#include <KOpeningHours/Interval>
+#include <KOpeningHours/OpeningHours>
+
+#include <QTest>
+#include <QTimeZone>
+
+using namespace KOpeningHours;
+
+void initLocale()
+{
+    qputenv("TZ", "Europe/Berlin");
+}
+
+Q_CONSTRUCTOR_FUNCTION(initLocale)
+
+class ExpressionCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testLookup()
+    {
+        ExpressionCache cache;
+        QCOMPARE(cache.count(), qsizetype(0));
+
+        const auto oh1 = cache.get("Mo-Fr 08:00-18:00");
+        QCOMPARE(oh1.error(), OpeningHours::NoError);
+        QCOMPARE(cache.missCount(), 1ull);
+        QCOMPARE(cache.hitCount(), 0ull);
+
+        const auto oh2 = cache.get("Mo-Fr 08:00-18:00");
+        QCOMPARE(oh2.error(), OpeningHours::NoError);
+        QCOMPARE(oh2.normalizedExpression(), oh1.normalizedExpression());
+        QCOMPARE(cache.missCount(), 1ull);
+        QCOMPARE(cache.hitCount(), 1ull);
+
+        // modes are part of the key
+        const auto oh3 = cache.get("Mo-Fr 08:00-18:00", OpeningHours::IntervalMode | OpeningHours::PointInTimeMode);
+        QCOMPARE(oh3.error(), OpeningHours::NoError);
+        QCOMPARE(cache.missCount(), 2ull);
+        QCOMPARE(cache.count(), qsizetype(2));
+        QVERIFY(cache.totalCost() > 0);
+
+        // invalid expressions are cached as well
+        QCOMPARE(cache.get("not an expression").error(), OpeningHours::SyntaxError);
+        QCOMPARE(cache.get("not an expression").error(), OpeningHours::SyntaxError);
+        QCOMPARE(cache.missCount(), 3ull);
+        QCOMPARE(cache.hitCount(), 2ull);
+
+        cache.clear();
+        QCOMPARE(cache.count(), qsizetype(0));
+        QCOMPARE(cache.hitCount(), 0ull);
+        QCOMPARE(oh1.normalizedExpression(), QByteArray("Mo-Fr 08:00-18:00"));
+    }
+
+    void testCopyOnWrite()
+    {
+        ExpressionCache cache;
+        auto oh1 = cache.get("Mo-Fr 08:00-18:00; PH off");
+        QCOMPARE(oh1.error(), OpeningHours::MissingRegion);
+
+        auto oh2 = cache.get("Mo-Fr 08:00-18:00; PH off");
+        oh2.setRegion(QStringLiteral("DE"));
+        QCOMPARE(oh2.error(), OpeningHours::NoError);
+        QCOMPARE(oh1.error(), OpeningHours::MissingRegion);
+        QCOMPARE(cache.get("Mo-Fr 08:00-18:00; PH off").error(), OpeningHours::MissingRegion);
+
+        const QDateTime dt({2020, 12, 25}, {12, 0});
+        QCOMPARE(oh2.interval(dt).state(), Interval::Closed);
+        QCOMPARE(oh2.interval(dt.addDays(-3)).state(), Interval::Open);
+
+        // copies of a detached instance are explicitly shared again
+        auto oh3 = oh2;
+        oh3.setTimeZone(QTimeZone("Asia/Tokyo"));
+        QCOMPARE(oh2.timeZone(), QTimeZone("Asia/Tokyo"));
+        QCOMPARE(cache.get("Mo-Fr 08:00-18:00; PH off").timeZone(), QTimeZone::systemTimeZone());
+
+        // changing the expression of a cached instance doesn't affect the cache
+        auto oh4 = cache.get("Mo-Fr 08:00-18:00");
+        oh4.setExpression("24/7");
+        QCOMPARE(oh4.normalizedExpression(), QByteArray("24/7"));
+        QCOMPARE(cache.get("Mo-Fr 08:00-18:00").normalizedExpression(), QByteArray("Mo-Fr 08:00-18:00"));
+    }
+
+    void testEviction()
+    {
+        ExpressionCache cache(0);
+        const auto oh = cache.get("Mo-Fr 08:00-18:00");
+        QCOMPARE(oh.error(), OpeningHours::NoError);
+        QCOMPARE(cache.count(), qsizetype(0));
+
+        cache.setMaximumCost(1024 * 1024);
+        for (int i = 0; i < 24; ++i) {
+            cache.get(QByteArray("Mo-Fr 08:00-") + QByteArray::number(i).rightJustified(2, '0') + ":00");
+        }
+        QCOMPARE(cache.count(), qsizetype(24));
+        cache.get("Mo-Fr 08:00-00:00");
+        QCOMPARE(cache.hitCount(), 1ull);
+
+        // least recently used entries are discarded first
+        cache.setMaximumCost(cache.totalCost() / 2);
+        QVERIFY(cache.count() < 24);
+        QVERIFY(cache.totalCost() <= cache.maximumCost());
+        const auto hits = cache.hitCount();
+        cache.get("Mo-Fr 08:00-00:00");
+        QCOMPARE(cache.hitCount(), hits + 1);
+        cache.get("Mo-Fr 08:00-01:00");
+        QCOMPARE(cache.hitCount(), hits + 1);
+    }
+};
+
+QTEST_GUILESS_MAIN(ExpressionCacheTest)
+
+#include "expressioncachetest.moc"
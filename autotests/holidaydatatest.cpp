@@ -0,0 +1,90 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KOpeningHours/HolidayData>
+#include <KOpeningHours/Interval>
+#include <KOpeningHours/OpeningHours>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace KOpeningHours;
+
+void initLocale()
+{
+    qputenv("TZ", "Europe/Berlin");
+}
+
+Q_CONSTRUCTOR_FUNCTION(initLocale)
+
+class HolidayDataTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCacheFile()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const auto fileName = dir.filePath(QStringLiteral("holidays.cache"));
+
+        HolidayData::prewarm({QStringLiteral("DE-BW"), QStringLiteral("AT")}, 2020, 2022);
+        QVERIFY(HolidayData::saveCache(fileName));
+        QVERIFY(QFile::exists(fileName));
+        QVERIFY(HolidayData::loadCache(fileName));
+
+        OpeningHours oh("Mo-Fr 08:00-18:00; PH off");
+        oh.setRegion(QStringLiteral("DE-BW"));
+        QCOMPARE(oh.error(), OpeningHours::NoError);
+        const auto i = oh.interval(QDateTime({2022, 1, 6}, {12, 0}));
+        QCOMPARE(i.state(), Interval::Closed);
+        QVERIFY(!i.comment().isEmpty());
+        QCOMPARE(oh.interval(QDateTime({2022, 1, 7}, {12, 0})).state(), Interval::Open);
+    }
+
+    void testCacheFileRegionData()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const auto fileName = dir.filePath(QStringLiteral("holidays.cache"));
+
+        // entries are only accepted if the holiday definitions of their region are found in KHolidays
+        HolidayData::prewarm({QStringLiteral("DE")}, 2020, 2022);
+        QVERIFY(HolidayData::saveCache(fileName));
+        QVERIFY(HolidayData::loadCache(fileName));
+    }
+
+    void testInvalidCacheFile()
+    {
+        QVERIFY(!HolidayData::loadCache(QStringLiteral("/does/not/exist")));
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const auto fileName = dir.filePath(QStringLiteral("holidays.cache"));
+        QVERIFY(HolidayData::saveCache(fileName));
+
+        QFile f(fileName);
+        QVERIFY(f.open(QFile::ReadWrite));
+        auto data = f.readAll();
+        QVERIFY(data.size() > 16);
+
+        // truncated
+        f.resize(data.size() / 2);
+        f.close();
+        QVERIFY(!HolidayData::loadCache(fileName));
+
+        // wrong magic
+        data[0] = 'X';
+        QVERIFY(f.open(QFile::WriteOnly | QFile::Truncate));
+        f.write(data);
+        f.close();
+        QVERIFY(!HolidayData::loadCache(fileName));
+    }
+};
+
+QTEST_GUILESS_MAIN(HolidayDataTest)
+
+#include "holidaydatatest.moc"
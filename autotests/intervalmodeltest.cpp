@@ -9,6 +9,7 @@
 
 #include <QAbstractItemModelTester>
 #include <QDateTime>
+#include <QSignalSpy>
 #include <QTest>
 
 using namespace KOpeningHours;
@@ -113,6 +114,37 @@ private Q_SLOTS:
         QCOMPARE(intervals[0].end(), QDateTime({ 2022, 12, 2 }, {0, 0}));
         QCOMPARE(intervals[0].state(), Interval::Closed);
     }
+
+    void testLargeRange()
+    {
+        IntervalModel model;
+        QAbstractItemModelTester modelTest(&model);
+        QSignalSpy dataChangedSpy(&model, &IntervalModel::dataChanged);
+
+        OpeningHours oh("Mo,We,Fr 10:00-20:00; Su 08:00-14:00");
+        model.setOpeningHours(oh);
+        model.setBeginDate({1970, 1, 1});
+        model.setEndDate({2100, 1, 1});
+        QCOMPARE(model.rowCount(), (int)QDate(1970, 1, 1).daysTo({2100, 1, 1}));
+
+        const auto row = (int)QDate(1970, 1, 1).daysTo({2020, 11, 2});
+        auto intervals = model.index(row, 0).data(IntervalModel::IntervalsRole).value<std::vector<Interval>>();
+        QCOMPARE(intervals.size(), 3);
+        QCOMPARE(intervals[1].begin(), QDateTime({2020, 11, 2}, {10, 0}));
+
+        // neighboring days are prefetched in the background
+        QVERIFY(dataChangedSpy.wait());
+        const auto first = dataChangedSpy.at(0).at(0).toModelIndex().row();
+        const auto last = dataChangedSpy.at(0).at(1).toModelIndex().row();
+        QVERIFY(first < row);
+        QVERIFY(last > row);
+        intervals = model.index(row + 2, 0).data(IntervalModel::IntervalsRole).value<std::vector<Interval>>();
+        QCOMPARE(intervals.size(), 3);
+        QCOMPARE(intervals[1].begin(), QDateTime({2020, 11, 4}, {10, 0}));
+        intervals = model.index(row + 1, 0).data(IntervalModel::IntervalsRole).value<std::vector<Interval>>();
+        QCOMPARE(intervals.size(), 1);
+        QCOMPARE(intervals[0].state(), Interval::Closed);
+    }
 };
 
 QTEST_GUILESS_MAIN(IntervalModelTest)
@@ -6,8 +6,10 @@
 
 #include <KOpeningHours/Interval>
 #include <KOpeningHours/OpeningHours>
+#include <KOpeningHours/Statistics>
 
 #include <kholidays_version.h>
+#include <KHolidays/SunRiseSet>
 
 #include <QDirIterator>
 #include <QFile>
@@ -128,6 +130,110 @@ private Q_SLOTS:
 
         QCOMPARE(refData, b);
     }
+
+    void testIterator_data()
+    {
+        testIterate_data();
+    }
+
+    void testIterator()
+    {
+        QFETCH(QString, inputFile);
+
+        QFile inFile(inputFile);
+        QVERIFY(inFile.open(QFile::ReadOnly | QFile::Text));
+
+        const auto expr = inFile.readLine();
+        OpeningHours oh(expr);
+        oh.setLocation(52.5, 13.0);
+        oh.setRegion(QStringLiteral("DE-BE"));
+        oh.setTimeZone(QTimeZone("Europe/Berlin"));
+        QCOMPARE(oh.error(), OpeningHours::NoError);
+
+        const auto iterationCount = inFile.readLine().toInt();
+        QByteArray b = expr + QByteArray::number(iterationCount) + "\n\n";
+        OpeningHours::Iterator it(oh, QDateTime({2020, 11, 7}, {18, 32, 14}));
+        b += intervalToString(it.interval());
+        for (int i = 0; it.interval().isValid() && i < iterationCount; ++i) {
+            if (it.next()) {
+                b += intervalToString(it.interval());
+            }
+        }
+
+        inFile.seek(0);
+        QCOMPARE(inFile.readAll(), b);
+    }
+
+    void testIteratorRuleEvaluations()
+    {
+        if (!Statistics::isEnabled()) {
+            QSKIP("built without statistics");
+        }
+
+        // date exceptions outside of the iterated range only need to be evaluated once
+        OpeningHours oh("Mo-Fr 08:00-18:00; Sa 10:00-14:00; Jan 01 off; Jan 06 off; Mar 08 off; Apr 18 off; Apr 21 off; May 01 off; "
+                        "May 29 off; Jun 09 off; Jun 19 off; Aug 15 off; Oct 03 off; Oct 31 off; Nov 01 off; Nov 20 off; "
+                        "Dec 24 off; Dec 25 off; Dec 26 off; Dec 31 off; Jul 01-Aug 31 Mo-Fr 09:00-17:00; Dec 23 10:00-12:00");
+        oh.setTimeZone(QTimeZone("Europe/Berlin"));
+        QCOMPARE(oh.error(), OpeningHours::NoError);
+        const QDateTime begin({2024, 2, 1}, {0, 0});
+        const QDateTime end({2024, 3, 1}, {0, 0});
+
+        Statistics::reset();
+        std::vector<Interval> reference{ oh.interval(begin) };
+        while (reference.back().end() < end) {
+            reference.push_back(oh.nextInterval(reference.back()));
+        }
+        const auto referenceCount = Statistics::snapshot().ruleEvaluationCount;
+
+        Statistics::reset();
+        OpeningHours::Iterator it(oh, begin);
+        std::vector<Interval> iterated{ it.interval() };
+        while (iterated.back().end() < end && it.next()) {
+            iterated.push_back(it.interval());
+        }
+        const auto iteratorCount = Statistics::snapshot().ruleEvaluationCount;
+
+        QCOMPARE(iterated.size(), reference.size());
+        for (std::size_t i = 0; i < reference.size(); ++i) {
+            QCOMPARE(intervalToString(iterated[i]), intervalToString(reference[i]));
+        }
+        QVERIFY(referenceCount > 0);
+        QVERIFY2(iteratorCount * 4 < referenceCount, QByteArray::number(iteratorCount) + " vs. " + QByteArray::number(referenceCount));
+    }
+
+    void testSunriseTimeZone_data()
+    {
+        QTest::addColumn<QByteArray>("timeZone");
+        QTest::addColumn<float>("latitude");
+        QTest::addColumn<float>("longitude");
+        QTest::newRow("Berlin") << QByteArray("Europe/Berlin") << 52.5f << 13.4f;
+        QTest::newRow("New York") << QByteArray("America/New_York") << 40.7f << -74.0f;
+        QTest::newRow("Kolkata") << QByteArray("Asia/Kolkata") << 22.6f << 88.4f;
+        QTest::newRow("Lord Howe") << QByteArray("Australia/Lord_Howe") << -31.5f << 159.1f; // 30min DST offset
+    }
+
+    void testSunriseTimeZone()
+    {
+        QFETCH(QByteArray, timeZone);
+        QFETCH(float, latitude);
+        QFETCH(float, longitude);
+        const QTimeZone tz(timeZone);
+        OpeningHours oh("sunrise-sunset");
+        oh.setLocation(latitude, longitude);
+        oh.setTimeZone(tz);
+        QCOMPARE(oh.error(), OpeningHours::NoError);
+
+        // days around DST changes on either hemisphere
+        for (const auto &date : { QDate(2021, 3, 26), QDate(2021, 3, 28), QDate(2021, 4, 4), QDate(2021, 6, 21),
+                                  QDate(2021, 10, 3), QDate(2021, 10, 31), QDate(2021, 11, 7), QDate(2021, 12, 21) }) {
+            const auto utcSunrise = QDateTime(date, KHolidays::SunRiseSet::utcSunrise(date, latitude, longitude), Qt::UTC).toTimeZone(tz);
+            const auto i = oh.interval(QDateTime(date, {12, 0}));
+            QCOMPARE(i.begin().date(), utcSunrise.date());
+            QCOMPARE(i.begin().time().hour(), utcSunrise.time().hour());
+            QCOMPARE(i.begin().time().minute(), utcSunrise.time().minute());
+        }
+    }
 };
 
 QTEST_GUILESS_MAIN(IterationTest)
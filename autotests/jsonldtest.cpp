@@ -7,6 +7,7 @@
 #include <KOpeningHours/OpeningHours>
 
 #include <QFile>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QTest>
@@ -32,6 +33,7 @@ private Q_SLOTS:
         T("oh-array", "Mo-Fr 10:00-19:00; Sa 10:00-22:00; Su 10:00-21:00");
         T("ohs-example", "Su 09:00-17:00 open; Sa 09:00-16:00 open; Th 09:00-15:00 open; Tu 09:00-14:00 open; Fr 09:00-13:00 open; Mo 09:00-12:00 open; We 09:00-11:00 open");
         T("ohs-mixed", "Mo,Tu,We,Th,Fr,Sa,Su 09:00-14:00; 2013 Dec 24-25 09:00-11:00 open; 2014 Jan 01 12:00-14:00 open");
+        T("ohs-merge", "Mo-Fr 09:00-18:00 open; Sa,Su 10:00-14:00 open; Fr 09:00-20:00 open; Fr 09:00-18:00 open");
 #undef T
     }
 
@@ -50,6 +52,30 @@ private Q_SLOTS:
         QCOMPARE(oh.error(), OpeningHours::NoError);
         QCOMPARE(oh.normalizedExpression(), osmExpr);
     }
+
+    void testJsonLdBatch()
+    {
+        QJsonArray objects;
+        for (const auto name : { "oh-simple", "oh-array", "ohs-example", "ohs-mixed", "ohs-merge" }) {
+            QFile inFile(QStringLiteral(SOURCE_DIR "/jsonlddata/") + QLatin1String(name) + QLatin1String(".json"));
+            QVERIFY(inFile.open(QFile::ReadOnly));
+            objects.push_back(QJsonDocument::fromJson(inFile.readAll()).object());
+        }
+        // enough to be split across multiple threads
+        while (objects.size() < 1000) {
+            objects.push_back(objects.at(objects.size() % 5));
+        }
+        objects.push_back(QJsonObject());
+
+        const auto ohs = OpeningHours::fromJsonLd(objects);
+        QCOMPARE(ohs.size(), std::size_t(objects.size()));
+        for (std::size_t i = 0; i < ohs.size(); ++i) {
+            const auto oh = OpeningHours::fromJsonLd(objects.at(i).toObject());
+            QCOMPARE(ohs[i].error(), oh.error());
+            QCOMPARE(ohs[i].normalizedExpression(), oh.normalizedExpression());
+        }
+        QCOMPARE(ohs.back().error(), OpeningHours::Null);
+    }
 };
 
 QTEST_GUILESS_MAIN(JsonLdTest)
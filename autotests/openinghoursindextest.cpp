@@ -0,0 +1,116 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KOpeningHours/Interval>
+#include <KOpeningHours/OpeningHours>
+#include <KOpeningHours/OpeningHoursIndex>
+
+#include <QTest>
+
+#include <algorithm>
+
+using namespace KOpeningHours;
+
+void initLocale()
+{
+    qputenv("TZ", "Europe/Berlin");
+}
+
+Q_CONSTRUCTOR_FUNCTION(initLocale)
+
+class OpeningHoursIndexTest : public QObject
+{
+    Q_OBJECT
+private:
+    static std::vector<OpeningHoursIndex::Id> sorted(std::vector<OpeningHoursIndex::Id> &&ids)
+    {
+        std::sort(ids.begin(), ids.end());
+        return std::move(ids);
+    }
+
+private Q_SLOTS:
+    void testQuery()
+    {
+        const char *exprs[] = { "Mo-Fr 08:00-18:00", "24/7", "off", "Mo-Fr 08:00-12:00,13:00-17:45; Sa 10:00-14:00",
+                                "sunrise-sunset", "Mo-Fr 09:00-18:00; PH off", "Mo-Su 18:00-02:00", "23/7", "Dec 25 10:00-12:00" };
+        std::vector<OpeningHours> ohs;
+        const QDateTime begin({2023, 12, 20}, {0, 0});
+        const QDateTime end({2023, 12, 28}, {0, 0});
+        OpeningHoursIndex index(begin, end);
+        for (const auto expr : exprs) {
+            OpeningHours oh(expr);
+            oh.setLocation(52.5, 13.4);
+            oh.setRegion(QStringLiteral("DE"));
+            ohs.push_back(oh);
+            index.insert(ohs.size() * 10, ohs.back());
+        }
+        QCOMPARE(index.size(), ohs.size());
+        QVERIFY(index.contains(10));
+        QVERIFY(!index.contains(1));
+
+        for (auto dt = begin; dt < end; dt = dt.addSecs(37 * 60)) {
+            std::vector<OpeningHoursIndex::Id> open, opening;
+            for (std::size_t i = 0; i < ohs.size(); ++i) {
+                const auto interval = ohs[i].interval(dt);
+                if (interval.state() == Interval::Open) {
+                    open.push_back((i + 1) * 10);
+                    continue;
+                }
+                if (!interval.isValid() || interval.hasOpenEnd() || interval.end() > dt.addSecs(3600)) {
+                    continue;
+                }
+                // the following interval can still be a closed one, but not in these expressions
+                if (ohs[i].nextInterval(interval).state() == Interval::Open) {
+                    opening.push_back((i + 1) * 10);
+                }
+            }
+            QCOMPARE(sorted(index.openAt(dt)), open);
+            QCOMPARE(sorted(index.opensWithin(dt, 3600)), opening);
+        }
+
+        // queries outside the window
+        QVERIFY(index.openAt(begin.addSecs(-60)).empty());
+        QVERIFY(index.openAt(end).empty());
+    }
+
+    void testUpdate()
+    {
+        const QDateTime begin({2023, 12, 20}, {0, 0});
+        OpeningHoursIndex index(begin, begin.addDays(7));
+        const QDateTime dt({2023, 12, 22}, {10, 0});
+
+        index.insert(1, OpeningHours("Mo-Fr 08:00-18:00"));
+        index.insert(2, OpeningHours("Sa 08:00-18:00"));
+        QCOMPARE(index.openAt(dt), std::vector<OpeningHoursIndex::Id>({1}));
+
+        index.insert(2, OpeningHours("Fr 08:00-18:00"));
+        QCOMPARE(index.size(), std::size_t(2));
+        QCOMPARE(sorted(index.openAt(dt)), std::vector<OpeningHoursIndex::Id>({1, 2}));
+
+        index.remove(1);
+        index.remove(3);
+        QVERIFY(!index.contains(1));
+        QCOMPARE(index.openAt(dt), std::vector<OpeningHoursIndex::Id>({2}));
+        QCOMPARE(index.opensWithin(dt.addSecs(-3 * 3600), 2 * 3600), std::vector<OpeningHoursIndex::Id>({2}));
+
+        // many updates, which triggers removal of outdated data
+        const OpeningHours oh("24/7");
+        for (int i = 0; i < 2000; ++i) {
+            index.insert(3, oh);
+        }
+        QCOMPARE(index.size(), std::size_t(2));
+        QCOMPARE(sorted(index.openAt(dt)), std::vector<OpeningHoursIndex::Id>({2, 3}));
+
+        // moving the window
+        index.setWindow(begin.addDays(7), begin.addDays(14));
+        QCOMPARE(sorted(index.openAt(dt.addDays(7))), std::vector<OpeningHoursIndex::Id>({2, 3}));
+        QCOMPARE(index.openAt(dt), std::vector<OpeningHoursIndex::Id>());
+    }
+};
+
+QTEST_GUILESS_MAIN(OpeningHoursIndexTest)
+
+#include "openinghoursindextest.moc"
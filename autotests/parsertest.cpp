@@ -8,6 +8,8 @@
 
 #include <QTest>
 
+#include <algorithm>
+
 using namespace KOpeningHours;
 
 class ParserTest : public QObject
@@ -383,6 +385,8 @@ private Q_SLOTS:
         T("easter +1 day 08:00-13:00; Tu,Sa,Su 08:00-13:00"); // does not simplify
         T3("Mo-Sa 12:00-15:00, Mo-Sa 18:00-24:00", "Mo-Sa 12:00-15:00, Mo-Sa 18:00-24:00", "Mo-Sa 12:00-15:00,18:00-24:00");
         T3("Mo 12:00-15:00, Mo 18:00-24:00", "Mo 12:00-15:00, Mo 18:00-24:00", "Mo 12:00-15:00,18:00-24:00");
+        T3("Mo 08:00-12:00, Mo 14:00-18:00, Mo 19:00-20:00", nullptr, "Mo 08:00-12:00,14:00-18:00,19:00-20:00");
+        T3("Mo 08:00-12:00; Tu 08:00-12:00; We 08:00-12:00; Th 09:00-12:00; Fr 09:00-12:00; Sa 09:00-12:00", nullptr, "Mo-We 08:00-12:00; Th-Sa 09:00-12:00");
         T3("Mo-We,Fr,Su 08:00-13:00", "Mo-We,Fr,Su 08:00-13:00", "Su-We,Fr 08:00-13:00");
         T3("Mo,We,Th,Tu,Sa 08:00-13:00", "Mo,We,Th,Tu,Sa 08:00-13:00", "Mo-Th,Sa 08:00-13:00"); // reordering
         T3("Mo-Fr,Tu,We 08:00-13:00", "Mo-Fr,Tu,We 08:00-13:00", "Mo-Fr 08:00-13:00"); // Tu,We already included
@@ -429,6 +433,13 @@ private Q_SLOTS:
         OpeningHours oh3(oh.simplifiedExpression());
         QVERIFY(oh3.error() != OpeningHours::SyntaxError);
         QCOMPARE(oh3.normalizedExpression(), oh.simplifiedExpression());
+
+        // verify serialization preserves the syntax tree
+        OpeningHours oh4;
+        QVERIFY(oh4.deserialize(oh.serialize()));
+        QCOMPARE(oh4.error(), oh.error());
+        QCOMPARE(oh4.normalizedExpression(), expectedOutput);
+        QCOMPARE(oh4.simplifiedExpression(), expectedSimplifiedOutput);
     }
 
     void testFail_data()
@@ -454,6 +465,8 @@ private Q_SLOTS:
         T("60p");
 
         T("Dec 24-Jan 1,6");
+        T("Dec 24-Jan 1,6-8");
+        T("Dec 24-Jan 1, 6");
         T("Mo, 1:100");
 
         // from https://wiki.openstreetmap.org/wiki/Key:opening_hours#Common_mistakes
@@ -519,6 +532,114 @@ private Q_SLOTS:
         (void)oh.normalizedExpression(); // don't crash
         (void)oh.simplifiedExpression(); // don't crash
     }
+
+    void testFastPath_data()
+    {
+        QTest::addColumn<QByteArray>("canonical");
+        QTest::addColumn<QByteArray>("variant");
+
+        // the variants are equivalent, but not in the canonical form handled by the fast path
+        QTest::newRow("24/7") << QByteArray("24/7") << QByteArray("24/7;");
+        QTest::newRow("24/7 off") << QByteArray("24/7 off") << QByteArray("24/7 OFF");
+        QTest::newRow("off") << QByteArray("off") << QByteArray("Off");
+        QTest::newRow("weekday range") << QByteArray("Mo-Fr 08:00-18:00") << QByteArray("mo-fr 08:00-18:00");
+        QTest::newRow("weekday only") << QByteArray("Mo-Fr") << QByteArray("Monday-Friday");
+        QTest::newRow("rule sequence") << QByteArray("Mo-Sa 09:00-20:00; Su off") << QByteArray("Mo-Sa 9:00-20:00; Su off");
+        QTest::newRow("weekday list") << QByteArray("Mo,We,Fr 08:00-12:00,13:00-17:30") << QByteArray("Mo,We,Fr 08:00-12:00,13:00-17:30;");
+        QTest::newRow("holidays") << QByteArray("Mo-Fr 09:00-18:00; PH off") << QByteArray("Mo-Fr 09:00-18:00; ph off");
+        QTest::newRow("holiday list") << QByteArray("Mo-Fr,PH 10:00-12:00 closed") << QByteArray("Mo-Fr,PH 10:00-12:00 Closed");
+        QTest::newRow("overnight") << QByteArray("Fr-Sa 18:00-02:00; Su 18:00-24:00 open") << QByteArray("Fr-Sa 18:00-02:00; Su 18:00-24:00 OPEN");
+        QTest::newRow("autocorrect") << QByteArray("Mo-Sa 12:00-15:00; 18:00-24:00") << QByteArray("Mo-Sa 12:00-15:00; 18:00-24:00;");
+        QTest::newRow("state") << QByteArray("Mo-Fr 08:00-18:00 unknown") << QByteArray("Mo-Fr 08:00-18:00 UNKNOWN");
+    }
+
+    void testFastPath()
+    {
+        QFETCH(QByteArray, canonical);
+        QFETCH(QByteArray, variant);
+
+        OpeningHours oh(canonical);
+        OpeningHours ref(variant);
+        QCOMPARE(oh.error(), ref.error());
+        QCOMPARE(oh.normalizedExpression(), ref.normalizedExpression());
+        QCOMPARE(oh.simplifiedExpression(), ref.simplifiedExpression());
+        QCOMPARE(oh.serialize(), ref.serialize());
+    }
+
+    void testFastPathFallback_data()
+    {
+        QTest::addColumn<QByteArray>("input");
+        QTest::addColumn<QByteArray>("expectedOutput");
+
+        // close to the canonical forms, but needing the full parser
+        QTest::newRow("additional rule") << QByteArray("Mo-Fr 08:00-12:00, Sa 10:00-12:00") << QByteArray("Mo-Fr 08:00-12:00, Sa 10:00-12:00");
+        QTest::newRow("holiday offset") << QByteArray("PH +1 day off") << QByteArray("PH +1 day off");
+        QTest::newRow("nth weekday") << QByteArray("Sa[1] 10:00-12:00") << QByteArray("Sa[1] 10:00-12:00");
+        QTest::newRow("open end") << QByteArray("Mo-Fr 18:00+") << QByteArray("Mo-Fr 18:00+");
+        QTest::newRow("comment") << QByteArray("Mo-Fr 08:00-18:00 \"on appointment\"") << QByteArray("Mo-Fr 08:00-18:00 \"on appointment\"");
+        QTest::newRow("invalid hour") << QByteArray("Mo-Fr 08:00-49:00") << QByteArray();
+        QTest::newRow("missing separator space") << QByteArray("Mo-Fr 08:00-18:00;Sa 10:00-12:00") << QByteArray("Mo-Fr 08:00-18:00; Sa 10:00-12:00");
+    }
+
+    void testFastPathFallback()
+    {
+        QFETCH(QByteArray, input);
+        QFETCH(QByteArray, expectedOutput);
+
+        OpeningHours oh(input);
+        QCOMPARE(oh.normalizedExpression(), expectedOutput);
+    }
+
+    void testSerialization()
+    {
+        OpeningHours oh("sunrise-sunset");
+        oh.setLocation(52.5f, 13.4f);
+        QCOMPARE(oh.error(), OpeningHours::NoError);
+
+        OpeningHours oh2;
+        QVERIFY(oh2.deserialize(oh.serialize()));
+        QCOMPARE(oh2.error(), OpeningHours::NoError);
+        QCOMPARE(oh2.latitude(), 52.5f);
+        QCOMPARE(oh2.longitude(), 13.4f);
+        QCOMPARE(oh2.normalizedExpression(), oh.normalizedExpression());
+
+        // syntax errors are preserved
+        OpeningHours invalid("23/7");
+        QVERIFY(oh2.deserialize(invalid.serialize()));
+        QCOMPARE(oh2.error(), OpeningHours::SyntaxError);
+
+        // invalid or truncated data
+        QVERIFY(!oh2.deserialize(QByteArray()));
+        QCOMPARE(oh2.error(), OpeningHours::Null);
+        QVERIFY(!oh2.deserialize(QByteArray("Mo-Fr 08:00-18:00")));
+        QCOMPARE(oh2.error(), OpeningHours::Null);
+        OpeningHours complex("Mo-Fr 08:00-12:00,13:00-18:00; Sa[1,3] 10:00-14:00; Jan 1 off; week 1-53/2 Su 10:00-12:00 \"by appointment\"");
+        const auto data = complex.serialize();
+        for (int i = 0; i < data.size(); ++i) {
+            oh2.deserialize(data.left(i)); // don't crash
+        }
+        QVERIFY(oh2.deserialize(data));
+        QCOMPARE(oh2.normalizedExpression(), complex.normalizedExpression());
+
+        // out of range values, patched into the first byte that differs for different values
+        const auto patched = [](const char *expr, const char *otherExpr, char value) {
+            auto data = OpeningHours(expr).serialize();
+            const auto otherData = OpeningHours(otherExpr).serialize();
+            Q_ASSERT(data.size() == otherData.size());
+            const auto idx = std::mismatch(data.begin(), data.end(), otherData.begin()).first - data.begin();
+            data[idx] = value;
+            return data;
+        };
+        QVERIFY(OpeningHours().deserialize(patched("Mo 10:00-12:00", "Tu 10:00-12:00", 2)));
+        QVERIFY(!oh2.deserialize(patched("Mo 10:00-12:00", "Tu 10:00-12:00", 8)));
+        QCOMPARE(oh2.error(), OpeningHours::Null);
+        QVERIFY(!oh2.deserialize(patched("Mo 10:00-12:00", "Tu 10:00-12:00", 0)));
+        QVERIFY(!oh2.deserialize(patched("Sa[1] 10:00-12:00", "Sa[2] 10:00-12:00", 6)));
+        QVERIFY(!oh2.deserialize(patched("Jan 10:00-12:00", "Feb 10:00-12:00", 13)));
+        QVERIFY(!oh2.deserialize(patched("Jan 10:00-12:00", "Feb 10:00-12:00", -1)));
+        QVERIFY(!oh2.deserialize(patched("Jan Su[1]-Mar Su[1] 10:00-12:00", "Jan Mo[1]-Mar Su[1] 10:00-12:00", 8)));
+        QVERIFY(!oh2.deserialize(patched("Jan 01 10:00-12:00", "Jan 02 10:00-12:00", 32)));
+    }
 };
 
 QTEST_GUILESS_MAIN(ParserTest)
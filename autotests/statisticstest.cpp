@@ -0,0 +1,73 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KOpeningHours/Interval>
+#include <KOpeningHours/OpeningHours>
+#include <KOpeningHours/Statistics>
+
+#include <QTest>
+
+#include <numeric>
+
+using namespace KOpeningHours;
+
+void initLocale()
+{
+    qputenv("TZ", "Europe/Berlin");
+}
+
+Q_CONSTRUCTOR_FUNCTION(initLocale)
+
+class StatisticsTest : public QObject
+{
+    Q_OBJECT
+private:
+    /** Returns the number of parser restarts for @p expr. */
+    static int evaluate(const char *expr)
+    {
+        OpeningHours oh(expr);
+        oh.setLocation(52.5, 13.4);
+        oh.setRegion(QStringLiteral("DE"));
+        oh.intervals(QDateTime({2023, 12, 20}, {0, 0}), QDateTime({2023, 12, 28}, {0, 0}));
+        return oh.parseStatistics().restartCount;
+    }
+
+private Q_SLOTS:
+    void testCounters()
+    {
+        Statistics::reset();
+        quint64 restarts = 0;
+        for (const auto expr : { "Mo-Fr 08:00-18:00; PH off", "sunrise-sunset", "Mo 12:00-14:00 Tu 12:00-14:00", "Mo-Fr 08:00-12:00,13:00-17:30" }) {
+            restarts += evaluate(expr);
+        }
+        const auto stats = Statistics::snapshot();
+
+        if (!Statistics::isEnabled()) {
+            QCOMPARE(stats.evaluationCount, quint64(0));
+            QCOMPARE(stats.ruleEvaluationCount, quint64(0));
+            QCOMPARE(stats.holidayCacheHits + stats.holidayCacheMisses, quint64(0));
+            QCOMPARE(stats.sunEventComputations, quint64(0));
+            QCOMPARE(stats.parserRestartCount, quint64(0));
+            return;
+        }
+
+        QVERIFY(stats.evaluationCount > 0);
+        QCOMPARE(std::accumulate(std::begin(stats.evaluationTimes), std::end(stats.evaluationTimes), quint64(0)), stats.evaluationCount);
+        QVERIFY(stats.ruleEvaluationCount > 0);
+        QCOMPARE(stats.recursionLimitCount, quint64(0));
+        QVERIFY(stats.holidayCacheHits + stats.holidayCacheMisses > 0);
+        QVERIFY(stats.sunEventComputations > 0);
+        QCOMPARE(stats.parserRestartCount, restarts);
+
+        Statistics::reset();
+        QCOMPARE(Statistics::snapshot().evaluationCount, quint64(0));
+        QCOMPARE(Statistics::snapshot().maxRecursionDepth, 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(StatisticsTest)
+
+#include "statisticstest.moc"
@@ -0,0 +1,156 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KOpeningHours/Interval>
+#include <KOpeningHours/OpeningHours>
+#include <KOpeningHours/WeeklyBitmapStore>
+
+#include <QTest>
+
+using namespace KOpeningHours;
+
+void initLocale()
+{
+    qputenv("TZ", "Europe/Berlin");
+}
+
+Q_CONSTRUCTOR_FUNCTION(initLocale)
+
+class WeeklyBitmapStoreTest : public QObject
+{
+    Q_OBJECT
+private:
+    std::vector<OpeningHours> m_expressions;
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        for (const auto expr : { "Mo-Fr 08:00-18:00", "24/7", "off", "Mo-Fr 08:00-12:00,13:00-17:45; Sa 10:00-14:00",
+                                 "Mo-Fr 08:10-18:00", "sunrise-sunset", "Mo-Fr 09:00-18:00; PH off", "Dec 24 off",
+                                 "23/7", "Mo-Su 18:00-02:00", "\"on appointment\"" }) {
+            OpeningHours oh(expr);
+            oh.setLocation(52.5, 13.4);
+            oh.setRegion(QStringLiteral("DE"));
+            m_expressions.push_back(oh);
+        }
+    }
+
+    void testOpenAt_data()
+    {
+        QTest::addColumn<QDateTime>("dt");
+        QTest::newRow("weekday morning") << QDateTime({2023, 12, 22}, {8, 0});
+        QTest::newRow("weekday noon") << QDateTime({2023, 12, 22}, {12, 30, 12});
+        QTest::newRow("weekday evening") << QDateTime({2023, 12, 22}, {17, 50});
+        QTest::newRow("saturday") << QDateTime({2023, 12, 23}, {13, 59});
+        QTest::newRow("christmas eve") << QDateTime({2023, 12, 24}, {11, 0});
+        QTest::newRow("christmas") << QDateTime({2023, 12, 25}, {11, 0});
+        QTest::newRow("night") << QDateTime({2023, 12, 26}, {1, 0});
+        QTest::newRow("sunday midnight") << QDateTime({2023, 12, 31}, {23, 59});
+    }
+
+    void testOpenAt()
+    {
+        QFETCH(QDateTime, dt);
+
+        WeeklyBitmapStore store;
+        for (const auto &oh : m_expressions) {
+            store.add(oh);
+        }
+        QCOMPARE(store.size(), m_expressions.size());
+        QVERIFY(!store.needsExactEvaluation(0));
+        QVERIFY(!store.needsExactEvaluation(1));
+        QVERIFY(store.needsExactEvaluation(4));
+        QVERIFY(store.needsExactEvaluation(5));
+        QVERIFY(!store.needsExactEvaluation(8));
+
+        const auto mask = store.openAt(dt);
+        for (std::size_t i = 0; i < m_expressions.size(); ++i) {
+            QCOMPARE(WeeklyBitmapStore::isSet(mask, i), m_expressions[i].interval(dt).state() == Interval::Open);
+        }
+    }
+
+    void testOpenDuring_data()
+    {
+        QTest::addColumn<QDateTime>("from");
+        QTest::addColumn<QDateTime>("to");
+        QTest::newRow("working hours") << QDateTime({2023, 12, 22}, {8, 0}) << QDateTime({2023, 12, 22}, {18, 0});
+        QTest::newRow("morning") << QDateTime({2023, 12, 22}, {8, 30}) << QDateTime({2023, 12, 22}, {11, 59, 30});
+        QTest::newRow("lunch") << QDateTime({2023, 12, 22}, {11, 0}) << QDateTime({2023, 12, 22}, {14, 0});
+        QTest::newRow("overnight") << QDateTime({2023, 12, 22}, {19, 0}) << QDateTime({2023, 12, 23}, {1, 0});
+        QTest::newRow("week wrap") << QDateTime({2023, 12, 31}, {20, 0}) << QDateTime({2024, 1, 1}, {1, 30});
+        QTest::newRow("long") << QDateTime({2023, 12, 1}, {0, 0}) << QDateTime({2024, 1, 1}, {0, 0});
+        QTest::newRow("empty") << QDateTime({2023, 12, 22}, {9, 0}) << QDateTime({2023, 12, 22}, {9, 0});
+    }
+
+    void testOpenDuring()
+    {
+        QFETCH(QDateTime, from);
+        QFETCH(QDateTime, to);
+
+        WeeklyBitmapStore store;
+        for (const auto &oh : m_expressions) {
+            store.add(oh);
+        }
+
+        const auto mask = store.openDuring(from, to);
+        for (std::size_t i = 0; i < m_expressions.size(); ++i) {
+            const auto &oh = m_expressions[i];
+            auto open = false;
+            if (oh.error() == OpeningHours::NoError) {
+                auto interval = oh.interval(from);
+                open = interval.state() == Interval::Open;
+                while (open && !interval.hasOpenEnd() && interval.end() < to) {
+                    interval = oh.nextInterval(interval);
+                    open = interval.state() == Interval::Open;
+                }
+            }
+            QCOMPARE(WeeklyBitmapStore::isSet(mask, i), open);
+        }
+    }
+
+    void testGrow()
+    {
+        WeeklyBitmapStore store;
+        const OpeningHours open("Mo-Fr 08:00-18:00");
+        const OpeningHours closed("Sa,Su 08:00-18:00");
+        OpeningHours sun("sunrise-sunset");
+        sun.setLocation(52.5, 13.4);
+        for (int i = 0; i < 1000; ++i) {
+            store.add(i % 3 == 0 ? open : i % 3 == 1 ? closed : sun);
+        }
+        QCOMPARE(store.size(), std::size_t(1000));
+        QCOMPARE(store.exactEvaluationCount(), std::size_t(333));
+
+        const auto mask = store.openAt(QDateTime({2023, 12, 22}, {12, 0}));
+        QCOMPARE(mask.size(), std::size_t(16));
+        for (int i = 0; i < 1000; ++i) {
+            QCOMPARE(WeeklyBitmapStore::isSet(mask, i), i % 3 != 1);
+        }
+
+        store.clear();
+        QCOMPARE(store.size(), std::size_t(0));
+        QVERIFY(store.openAt(QDateTime({2023, 12, 22}, {12, 0})).empty());
+    }
+
+    void testInvalidTime()
+    {
+        WeeklyBitmapStore store;
+        store.add(OpeningHours("24/7"));
+        OpeningHours oh("sunrise-sunset");
+        oh.setLocation(52.5, 13.4);
+        store.add(oh);
+        QVERIFY(store.needsExactEvaluation(1));
+
+        const auto zero = std::vector<quint64>(1, 0);
+        QCOMPARE(store.openAt(QDateTime()), zero);
+        QCOMPARE(store.openDuring(QDateTime(), QDateTime({2023, 12, 22}, {12, 0})), zero);
+        QCOMPARE(store.openDuring(QDateTime({2023, 12, 22}, {12, 0}), QDateTime()), zero);
+    }
+};
+
+QTEST_GUILESS_MAIN(WeeklyBitmapStoreTest)
+
+#include "weeklybitmapstoretest.moc"
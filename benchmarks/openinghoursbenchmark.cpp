@@ -0,0 +1,263 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KOpeningHours/Interval>
+#include <KOpeningHours/OpeningHours>
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+#include <KOpeningHours/WeeklyBitmapStore>
+#endif
+
+#include <QDirIterator>
+#include <QFile>
+#include <QTest>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+using namespace KOpeningHours;
+
+void initLocale()
+{
+    qputenv("TZ", "Europe/Berlin");
+}
+
+Q_CONSTRUCTOR_FUNCTION(initLocale)
+
+/** Benchmarks for the most common operations.
+ *  Each benchmark processes an entire corpus of expressions per iteration, divide
+ *  the corpus size (shown in the row name) by the time per iteration to get expressions/s.
+ */
+class OpeningHoursBenchmark : public QObject
+{
+    Q_OBJECT
+private:
+    std::vector<QByteArray> m_autotestCorpus;
+    std::vector<QByteArray> m_osmCorpus;
+
+    // the first line of each of the iteration test input files
+    static std::vector<QByteArray> loadAutotestCorpus()
+    {
+        std::vector<QByteArray> corpus;
+        QDirIterator it(QStringLiteral(AUTOTESTS_DATA_DIR), {QStringLiteral("*.intervals")}, QDir::Files);
+        while (it.hasNext()) {
+            QFile f(it.next());
+            if (f.open(QFile::ReadOnly)) {
+                corpus.push_back(f.readLine().trimmed());
+            }
+        }
+        return corpus;
+    }
+
+    static std::vector<QByteArray> loadOsmCorpus()
+    {
+        std::vector<QByteArray> corpus;
+        QFile f(QStringLiteral(BENCHMARK_DATA_DIR "/osm-sample.txt"));
+        if (f.open(QFile::ReadOnly)) {
+            while (!f.atEnd()) {
+                const auto line = f.readLine().trimmed();
+                if (!line.isEmpty()) {
+                    corpus.push_back(line);
+                }
+            }
+        }
+        return corpus;
+    }
+
+    void addCorpusRows()
+    {
+        QTest::addColumn<QString>("corpus");
+        QTest::addColumn<QByteArray>("filter");
+
+        const auto addRow = [this](const char *name, const QString &corpus, const QByteArray &filter) {
+            QTest::addRow("%s (%d)", name, (int)filteredCorpus(corpus, filter).size()) << corpus << filter;
+        };
+        addRow("autotests", QStringLiteral("autotests"), QByteArray());
+        addRow("osm", QStringLiteral("osm"), QByteArray());
+        addRow("osm PH", QStringLiteral("osm"), QByteArrayLiteral("PH"));
+        addRow("osm sun", QStringLiteral("osm"), QByteArrayLiteral("sun"));
+    }
+
+    std::vector<QByteArray> filteredCorpus(const QString &corpus, const QByteArray &filter) const
+    {
+        const auto &source = corpus == QLatin1String("autotests") ? m_autotestCorpus : m_osmCorpus;
+        std::vector<QByteArray> result;
+        std::copy_if(source.begin(), source.end(), std::back_inserter(result), [&filter](const auto &expr) {
+            return filter.isEmpty() || expr.contains(filter);
+        });
+        return result;
+    }
+
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+    std::vector<OpeningHours> validExpressions(const QString &corpus, const QByteArray &filter) const
+    {
+        std::vector<OpeningHours> result;
+        for (const auto &expr : filteredCorpus(corpus, filter)) {
+            OpeningHours oh(expr);
+            oh.setLocation(52.5, 13.4);
+            oh.setRegion(QStringLiteral("DE"));
+            if (oh.error() == OpeningHours::NoError) {
+                result.push_back(oh);
+            }
+        }
+        return result;
+    }
+#endif
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        m_autotestCorpus = loadAutotestCorpus();
+        m_osmCorpus = loadOsmCorpus();
+        QVERIFY(!m_autotestCorpus.empty());
+        QVERIFY(!m_osmCorpus.empty());
+    }
+
+    void benchmarkParse_data()
+    {
+        addCorpusRows();
+    }
+    void benchmarkParse()
+    {
+        QFETCH(QString, corpus);
+        QFETCH(QByteArray, filter);
+        const auto exprs = filteredCorpus(corpus, filter);
+
+        OpeningHours oh;
+        QBENCHMARK {
+            for (const auto &expr : exprs) {
+                oh.setExpression(expr);
+            }
+        }
+    }
+
+    void benchmarkNormalize_data()
+    {
+        addCorpusRows();
+    }
+    void benchmarkNormalize()
+    {
+        QFETCH(QString, corpus);
+        QFETCH(QByteArray, filter);
+        std::vector<OpeningHours> ohs;
+        for (const auto &expr : filteredCorpus(corpus, filter)) {
+            ohs.emplace_back(expr);
+        }
+
+        QBENCHMARK {
+            for (const auto &oh : ohs) {
+                oh.normalizedExpression();
+            }
+        }
+    }
+
+    void benchmarkSimplify_data()
+    {
+        addCorpusRows();
+    }
+    void benchmarkSimplify()
+    {
+        QFETCH(QString, corpus);
+        QFETCH(QByteArray, filter);
+        std::vector<OpeningHours> ohs;
+        for (const auto &expr : filteredCorpus(corpus, filter)) {
+            ohs.emplace_back(expr);
+        }
+
+        QBENCHMARK {
+            for (const auto &oh : ohs) {
+                oh.simplifiedExpression();
+            }
+        }
+    }
+
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+    void benchmarkInterval_data()
+    {
+        addCorpusRows();
+    }
+    void benchmarkInterval()
+    {
+        QFETCH(QString, corpus);
+        QFETCH(QByteArray, filter);
+        const auto ohs = validExpressions(corpus, filter);
+        const QDateTime dt({2023, 12, 22}, {18, 32});
+
+        QBENCHMARK {
+            for (const auto &oh : ohs) {
+                oh.interval(dt);
+            }
+        }
+    }
+
+    void benchmarkOpenAt_data()
+    {
+        addCorpusRows();
+    }
+    void benchmarkOpenAt()
+    {
+        QFETCH(QString, corpus);
+        QFETCH(QByteArray, filter);
+        WeeklyBitmapStore store;
+        for (const auto &oh : validExpressions(corpus, filter)) {
+            store.add(oh);
+        }
+        const QDateTime dt({2023, 12, 22}, {18, 32});
+
+        QBENCHMARK {
+            store.openAt(dt);
+        }
+    }
+
+    void benchmarkIterate_data()
+    {
+        addCorpusRows();
+    }
+    void benchmarkIterate()
+    {
+        QFETCH(QString, corpus);
+        QFETCH(QByteArray, filter);
+        const auto ohs = validExpressions(corpus, filter);
+        const QDateTime begin({2023, 12, 22}, {18, 32});
+        const auto end = begin.addDays(30);
+
+        QBENCHMARK {
+            for (const auto &oh : ohs) {
+                auto i = oh.interval(begin);
+                while (i.isValid() && !i.hasOpenEnd() && i.end() < end) {
+                    i = oh.nextInterval(i);
+                }
+            }
+        }
+    }
+
+    void benchmarkIterator_data()
+    {
+        addCorpusRows();
+    }
+    void benchmarkIterator()
+    {
+        QFETCH(QString, corpus);
+        QFETCH(QByteArray, filter);
+        const auto ohs = validExpressions(corpus, filter);
+        const QDateTime begin({2023, 12, 22}, {18, 32});
+        const auto end = begin.addDays(30);
+
+        QBENCHMARK {
+            for (const auto &oh : ohs) {
+                OpeningHours::Iterator it(oh, begin);
+                while (it.interval().isValid() && !it.interval().hasOpenEnd() && it.interval().end() < end) {
+                    it.next();
+                }
+            }
+        }
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(OpeningHoursBenchmark)
+
+#include "openinghoursbenchmark.moc"
@@ -0,0 +1,68 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "astarena_p.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace KOpeningHours;
+
+AstArena::AstArena() = default;
+
+AstArena::~AstArena()
+{
+    clear();
+}
+
+void AstArena::clear()
+{
+    // destructors are in reverse order of construction
+    for (auto d = m_destructors; d; d = d->next) {
+        d->destroy(d->obj);
+    }
+    m_destructors = nullptr;
+
+    while (m_blocks) {
+        auto next = m_blocks->next;
+        std::free(m_blocks);
+        m_blocks = next;
+    }
+    m_pos = m_initialBlock;
+    m_end = m_initialBlock + InitialBlockSize;
+}
+
+std::size_t AstArena::allocatedSize() const
+{
+    std::size_t size = sizeof(AstArena);
+    for (auto block = m_blocks; block; block = block->next) {
+        size += block->size;
+    }
+    return size;
+}
+
+void* AstArena::allocate(std::size_t size, std::size_t alignment)
+{
+    auto pos = reinterpret_cast<std::uintptr_t>(m_pos);
+    pos = (pos + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    if (pos + size > reinterpret_cast<std::uintptr_t>(m_end)) {
+        // double the size with every new block, so even pathological expressions only need a few
+        const auto blockSize = std::max<std::size_t>(m_blocks ? m_blocks->size * 2 : InitialBlockSize * 2, size + alignment + sizeof(Block));
+        auto block = static_cast<Block*>(std::malloc(blockSize));
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        block->next = m_blocks;
+        block->size = blockSize;
+        m_blocks = block;
+        m_pos = reinterpret_cast<char*>(block) + sizeof(Block);
+        m_end = reinterpret_cast<char*>(block) + blockSize;
+        return allocate(size, alignment);
+    }
+    m_pos = reinterpret_cast<char*>(pos + size);
+    return reinterpret_cast<void*>(pos);
+}
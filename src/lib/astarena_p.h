@@ -0,0 +1,76 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_ASTARENA_P_H
+#define KOPENINGHOURS_ASTARENA_P_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace KOpeningHours {
+
+/** Bump allocator owning all rule and selector nodes of an expression.
+ *  Nodes allocated in this are never freed individually, they are destroyed
+ *  all at once on clear() or destruction of the arena. The first block is part
+ *  of the arena itself, so typical expressions don't need any heap allocation
+ *  for their syntax tree at all, and nodes of one rule end up next to each other
+ *  in memory.
+ */
+class AstArena
+{
+public:
+    AstArena();
+    ~AstArena();
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+
+    /** Allocates and default-constructs a new node. */
+    template <typename T>
+    T* create()
+    {
+        if constexpr (std::is_trivially_destructible_v<T>) {
+            return new (allocate(sizeof(T), alignof(T))) T;
+        } else {
+            auto entry = new (allocate(sizeof(Destructor), alignof(Destructor))) Destructor;
+            auto obj = new (allocate(sizeof(T), alignof(T))) T;
+            entry->obj = obj;
+            entry->destroy = [](void *obj) { static_cast<T*>(obj)->~T(); };
+            entry->next = m_destructors;
+            m_destructors = entry;
+            return obj;
+        }
+    }
+
+    /** Destroys all nodes and releases all memory but the initial block. */
+    void clear();
+    /** Memory used by this arena, in bytes. */
+    std::size_t allocatedSize() const;
+
+private:
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    struct Destructor {
+        void *obj;
+        void (*destroy)(void*);
+        Destructor *next;
+    };
+    struct Block {
+        Block *next;
+        std::size_t size;
+    };
+
+    enum { InitialBlockSize = 512 };
+    alignas(std::max_align_t) char m_initialBlock[InitialBlockSize];
+    Block *m_blocks = nullptr;
+    Destructor *m_destructors = nullptr;
+    char *m_pos = m_initialBlock;
+    char *m_end = m_initialBlock + InitialBlockSize;
+};
+
+}
+
+#endif // KOPENINGHOURS_ASTARENA_P_H
@@ -0,0 +1,48 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "batchevaluator.h"
+#include "openinghours.h"
+#include "threadpool_p.h"
+
+using namespace KOpeningHours;
+
+// below this there is no point in distributing work to other threads
+enum { MinimumJobSize = 256 };
+
+static void evaluateRange(const OpeningHours *expressions, std::size_t count, const QDateTime &dt, BatchEvaluator::Result *results)
+{
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        const auto &oh = expressions[idx];
+        auto &res = results[idx];
+        if (oh.error() != OpeningHours::NoError) {
+            res = {};
+            continue;
+        }
+
+        const auto i = oh.interval(dt);
+        res.state = i.state();
+        res.nextChange = i.end();
+    }
+}
+
+void BatchEvaluator::evaluate(const OpeningHours *expressions, std::size_t count, const QDateTime &dt, Result *results, ExecutionPolicy policy)
+{
+    if (policy != Parallel) {
+        evaluateRange(expressions, count, dt, results);
+        return;
+    }
+    ThreadPool::forEachChunk(count, MinimumJobSize, [=, &dt](std::size_t offset, std::size_t chunk) {
+        evaluateRange(expressions + offset, chunk, dt, results + offset);
+    });
+}
+
+std::vector<BatchEvaluator::Result> BatchEvaluator::evaluate(const std::vector<OpeningHours> &expressions, const QDateTime &dt, ExecutionPolicy policy)
+{
+    std::vector<Result> results(expressions.size());
+    evaluate(expressions.data(), expressions.size(), dt, results.data(), policy);
+    return results;
+}
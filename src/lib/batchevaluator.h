@@ -0,0 +1,55 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_BATCHEVALUATOR_H
+#define KOPENINGHOURS_BATCHEVALUATOR_H
+
+#include "kopeninghours_export.h"
+#include "interval.h"
+
+#include <QDateTime>
+
+#include <cstddef>
+#include <vector>
+
+namespace KOpeningHours {
+
+class OpeningHours;
+
+/** Evaluates many opening hours expressions for the same point in time.
+ *  This is useful for e.g. checking which of a large set of places are open right now.
+ */
+class KOPENINGHOURS_EXPORT BatchEvaluator
+{
+public:
+    /** Determines how the work is distributed. */
+    enum ExecutionPolicy {
+        Sequential, ///< evaluate all expressions on the calling thread
+        Parallel, ///< split the work across the global thread pool
+    };
+
+    /** Evaluation result for a single expression. */
+    struct Result {
+        /** The state at the evaluated point in time, @c Interval::Invalid for invalid expressions. */
+        Interval::State state = Interval::Invalid;
+        /** The end of the interval containing the evaluated point in time,
+         *  ie. the time the state might change next. Invalid if the state never changes.
+         */
+        QDateTime nextChange;
+    };
+
+    /** Evaluate @p count opening hours expressions starting at @p expressions for @p dt.
+     *  @param results Preallocated array of at least @p count elements, the result for
+     *  the expression at index @c i is written to index @c i.
+     */
+    static void evaluate(const OpeningHours *expressions, std::size_t count, const QDateTime &dt, Result *results, ExecutionPolicy policy = Sequential);
+    /** Evaluate all @p expressions for @p dt. */
+    static std::vector<Result> evaluate(const std::vector<OpeningHours> &expressions, const QDateTime &dt, ExecutionPolicy policy = Sequential);
+};
+
+}
+
+#endif // KOPENINGHOURS_BATCHEVALUATOR_H
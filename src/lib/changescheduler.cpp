@@ -0,0 +1,228 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "changescheduler.h"
+#include "openinghours.h"
+#include "slotmap_p.h"
+
+#include <QDateTime>
+#include <QTimer>
+
+#include <algorithm>
+#include <limits>
+
+using namespace KOpeningHours;
+
+// the timer is restarted at least this often, which also covers changes of the system clock
+enum { MaximumTimerInterval = 3600 * 1000 };
+
+namespace KOpeningHours {
+class ChangeSchedulerPrivate
+{
+public:
+    /** Scheduled end of the current interval of an entry, in milliseconds since epoch. */
+    struct Item {
+        qint64 end;
+        quint32 slot;
+        quint32 generation;
+    };
+    struct Entry {
+        OpeningHours openingHours;
+        Interval interval;
+    };
+
+    // the heap compares the other way around to have the earliest item at the front
+    static inline bool laterThan(const Item &lhs, const Item &rhs)
+    {
+        return lhs.end > rhs.end;
+    }
+    inline bool isLive(const Item &item) const
+    {
+        return slots.isLive(item.slot, item.generation);
+    }
+
+    /** Evaluates @p slot for @p dt and schedules the end of the resulting interval. */
+    void evaluate(quint32 slot, const QDateTime &dt);
+    /** Re-evaluates the slots in @p due for @p dt, and emits changed() for those with a different result. */
+    void reevaluate(const std::vector<quint32> &due, const QDateTime &dt);
+    void compactIfNeeded();
+    void restartTimer();
+
+    ChangeScheduler *q = nullptr;
+    std::vector<Item> heap;
+    SlotMap<Entry> slots;
+    // latest time anything was evaluated for, to detect the clock going backwards
+    qint64 lastEvaluation = std::numeric_limits<qint64>::min();
+    QTimer timer;
+};
+}
+
+void ChangeSchedulerPrivate::evaluate(quint32 slot, const QDateTime &dt)
+{
+    lastEvaluation = std::max(lastEvaluation, dt.toMSecsSinceEpoch());
+    auto &s = slots[slot].value;
+    if (s.openingHours.error() != OpeningHours::NoError) {
+        s.interval = {};
+        return;
+    }
+
+    s.interval = s.openingHours.interval(dt);
+    if (!s.interval.isValid() || s.interval.hasOpenEnd() || !s.interval.end().isValid() || s.interval.end() <= dt) {
+        return;
+    }
+    heap.push_back({ s.interval.end().toMSecsSinceEpoch(), slot, slots[slot].generation });
+    std::push_heap(heap.begin(), heap.end(), laterThan);
+    slots.addItems(slot, 1);
+}
+
+void ChangeSchedulerPrivate::reevaluate(const std::vector<quint32> &due, const QDateTime &dt)
+{
+    std::vector<ChangeScheduler::Id> changed;
+    for (const auto slot : due) {
+        const auto prev = slots[slot].value.interval;
+        evaluate(slot, dt);
+        const auto &interval = slots[slot].value.interval;
+        if (interval.state() != prev.state() || interval.comment() != prev.comment()) {
+            changed.push_back(slots[slot].id);
+        }
+    }
+
+    restartTimer();
+    if (!changed.empty()) {
+        Q_EMIT q->changed(changed);
+    }
+}
+
+void ChangeSchedulerPrivate::compactIfNeeded()
+{
+    if (!slots.needsCompaction()) {
+        return;
+    }
+
+    heap.erase(std::remove_if(heap.begin(), heap.end(), [this](const Item &item) { return !isLive(item); }), heap.end());
+    std::make_heap(heap.begin(), heap.end(), laterThan);
+    slots.compacted();
+}
+
+void ChangeSchedulerPrivate::restartTimer()
+{
+    // drop stale entries at the front, so the timer doesn't fire for nothing
+    while (!heap.empty() && !isLive(heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), laterThan);
+        heap.pop_back();
+        slots.removeStaleItems(1);
+    }
+    if (heap.empty()) {
+        timer.stop();
+        return;
+    }
+
+    const auto msecs = heap.front().end - QDateTime::currentMSecsSinceEpoch();
+    timer.start(static_cast<int>(std::clamp<qint64>(msecs, 0, MaximumTimerInterval)));
+}
+
+ChangeScheduler::ChangeScheduler(QObject *parent)
+    : QObject(parent)
+    , d(new ChangeSchedulerPrivate)
+{
+    d->q = this;
+    d->timer.setSingleShot(true);
+    d->timer.setTimerType(Qt::PreciseTimer);
+    connect(&d->timer, &QTimer::timeout, this, [this]() {
+        update(QDateTime::currentDateTime());
+    });
+}
+
+ChangeScheduler::~ChangeScheduler() = default;
+
+void ChangeScheduler::insert(Id id, const OpeningHours &openingHours, const QDateTime &dt)
+{
+    const auto slot = d->slots.insert(id);
+    d->slots[slot].value.openingHours = openingHours;
+    d->evaluate(slot, dt);
+    d->compactIfNeeded();
+    d->restartTimer();
+}
+
+void ChangeScheduler::remove(Id id)
+{
+    if (d->slots.remove(id)) {
+        d->compactIfNeeded();
+        d->restartTimer();
+    }
+}
+
+void ChangeScheduler::clear()
+{
+    d->heap.clear();
+    d->slots.clear();
+    d->lastEvaluation = std::numeric_limits<qint64>::min();
+    d->timer.stop();
+}
+
+bool ChangeScheduler::contains(Id id) const
+{
+    return d->slots.contains(id);
+}
+
+std::size_t ChangeScheduler::size() const
+{
+    return d->slots.size();
+}
+
+Interval ChangeScheduler::interval(Id id) const
+{
+    const auto slot = d->slots.find(id);
+    return slot ? slot->value.interval : Interval();
+}
+
+Interval::State ChangeScheduler::state(Id id) const
+{
+    const auto i = interval(id);
+    return i.isValid() ? i.state() : Interval::Invalid;
+}
+
+QDateTime ChangeScheduler::nextChange() const
+{
+    // restartTimer() ensures the front entry is live
+    return d->heap.empty() ? QDateTime() : QDateTime::fromMSecsSinceEpoch(d->heap.front().end);
+}
+
+void ChangeScheduler::update(const QDateTime &dt)
+{
+    const auto msecs = dt.toMSecsSinceEpoch();
+    std::vector<quint32> due;
+
+    if (msecs < d->lastEvaluation) {
+        // the clock went backwards, so the current interval of any entry might be a future one
+        d->heap.clear();
+        d->slots.resetItems();
+        for (quint32 slot = 0; slot < d->slots.slotCount(); ++slot) {
+            if (d->slots[slot].used) {
+                due.push_back(slot);
+            }
+        }
+        d->lastEvaluation = msecs;
+        d->reevaluate(due, dt);
+        return;
+    }
+
+    while (!d->heap.empty() && d->heap.front().end <= msecs) {
+        const auto item = d->heap.front();
+        std::pop_heap(d->heap.begin(), d->heap.end(), ChangeSchedulerPrivate::laterThan);
+        d->heap.pop_back();
+        if (d->isLive(item)) {
+            d->slots.removeItems(item.slot, 1);
+            due.push_back(item.slot);
+        } else {
+            d->slots.removeStaleItems(1);
+        }
+    }
+    // re-evaluating only after collecting everything that is due, so the new heap entries don't end up in the loop above
+    d->reevaluate(due, dt);
+}
+
+#include "moc_changescheduler.cpp"
@@ -0,0 +1,85 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_CHANGESCHEDULER_H
+#define KOPENINGHOURS_CHANGESCHEDULER_H
+
+#include "kopeninghours_export.h"
+
+#include <KOpeningHours/Interval>
+
+#include <QObject>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class QDateTime;
+
+namespace KOpeningHours {
+
+class ChangeSchedulerPrivate;
+class OpeningHours;
+
+/** Tracks the current state of many opening hours expressions.
+ *  Rather than periodically re-evaluating all entries, this computes the end of the current
+ *  interval of each entry, and uses a single timer for the earliest of those. Only the entries
+ *  whose current interval ended are re-evaluated then. This is useful for e.g. keeping a large
+ *  amount of "open now" displays up to date.
+ */
+class KOPENINGHOURS_EXPORT ChangeScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    /** Application-defined identifier of an entry, e.g. an OSM element id. */
+    using Id = quint64;
+
+    explicit ChangeScheduler(QObject *parent = nullptr);
+    ~ChangeScheduler() override;
+
+    /** Adds @p openingHours as entry @p id, replacing a previous entry with the same id.
+     *  The entry is evaluated for @p dt right away, which usually is the current time.
+     */
+    void insert(Id id, const OpeningHours &openingHours, const QDateTime &dt);
+    /** Removes entry @p id, if present. */
+    void remove(Id id);
+    /** Removes all entries. */
+    void clear();
+    /** Returns @c true if there is an entry @p id. */
+    bool contains(Id id) const;
+    /** Amount of entries. */
+    std::size_t size() const;
+
+    /** The current interval of entry @p id.
+     *  Invalid for unknown entries and for entries with an invalid expression.
+     */
+    Interval interval(Id id) const;
+    /** The current state of entry @p id, @c Interval::Invalid for unknown entries. */
+    Interval::State state(Id id) const;
+    /** The earliest time the current interval of any entry ends.
+     *  Invalid if there are no upcoming changes.
+     */
+    QDateTime nextChange() const;
+
+    /** Re-evaluates all entries whose current interval ended at or before @p dt.
+     *  If @p dt is earlier than any time previously passed to this or to insert(), e.g. because
+     *  the system clock was turned back, all entries are re-evaluated.
+     *  This is done automatically for the current time when the next change is due, and at least
+     *  once per hour. Calling this manually is only necessary to react to clock changes immediately.
+     */
+    void update(const QDateTime &dt);
+
+Q_SIGNALS:
+    /** Emitted when the state or the comment of the entries @p ids changed, in no particular order. */
+    void changed(const std::vector<KOpeningHours::ChangeScheduler::Id> &ids);
+
+private:
+    std::unique_ptr<ChangeSchedulerPrivate> d;
+};
+
+}
+
+#endif // KOPENINGHOURS_CHANGESCHEDULER_H
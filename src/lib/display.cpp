@@ -10,6 +10,8 @@
 
 #include <KLocalizedString>
 
+#include <QtConcurrentRun>
+
 #include <cmath>
 
 using namespace KOpeningHours;
@@ -111,4 +113,11 @@ QString Display::currentState(const OpeningHours &oh)
     return {};
 }
 
+QFuture<QString> Display::currentStateAsync(const OpeningHours &oh)
+{
+    return QtConcurrent::run([oh]() {
+        return currentState(oh);
+    });
+}
+
 #include "moc_display.cpp"
@@ -9,9 +9,8 @@
 
 #include "kopeninghours_export.h"
 
-#include <qobjectdefs.h>
-
-class QString;
+#include <QFuture>
+#include <QString>
 
 namespace KOpeningHours {
 
@@ -24,6 +23,10 @@ class KOPENINGHOURS_EXPORT Display
 public:
     /** Localized description of the current opening state, and upcoming transitions. */
     Q_INVOKABLE static QString currentState(const KOpeningHours::OpeningHours &oh);
+    /** Asynchronous variant of currentState(), evaluated on the global thread pool.
+     *  @see OpeningHours::intervalAsync()
+     */
+    static QFuture<QString> currentStateAsync(const KOpeningHours::OpeningHours &oh);
 };
 
 }
@@ -11,10 +11,13 @@
 
 #include "easter_p.h"
 #include "holidaycache_p.h"
+#include "statistics_p.h"
 
 #include <QCalendar>
 #include <QDateTime>
 
+#include <algorithm>
+
 using namespace KOpeningHours;
 
 static int daysInMonth(int month)
@@ -22,28 +25,71 @@ static int daysInMonth(int month)
     return QCalendar(QCalendar::System::Gregorian).daysInMonth(month);
 }
 
-static QDateTime resolveTime(Time t, QDate date, OpeningHoursPrivate *context)
+LocalDateTime OpeningHoursPrivate::sunEvent(Time::Event event, QDate date)
 {
-    QDateTime dt;
-    switch (t.event) {
+    const auto idx = static_cast<int>(event) - 1;
+    const auto jd = date.toJulianDay();
+    std::shared_ptr<const TimeZoneCache::Table> timezoneTable;
+    {
+        QMutexLocker locker(&m_sunEventMutex);
+        const auto it = m_sunEvents.constFind(jd);
+        if (it != m_sunEvents.constEnd() && ((*it).resolved & (1 << idx))) {
+            return (*it).events[idx];
+        }
+        timezoneTable = m_timezoneTable;
+    }
+    if (!timezoneTable) {
+        timezoneTable = TimeZoneCache::lookup(m_timezone);
+    }
+    StatisticsCollector::increment(StatisticsCollector::SunEventComputations);
+
+    QTime t;
+    switch (event) {
         case Time::NoEvent:
-            return QDateTime(date, {t.hour % 24, t.minute});
+            return {};
         case Time::Dawn:
-            dt = QDateTime(date, KHolidays::SunRiseSet::utcDawn(date, context->m_latitude, context->m_longitude), Qt::UTC).toTimeZone(context->m_timezone);            break;
+            t = KHolidays::SunRiseSet::utcDawn(date, m_latitude, m_longitude);
+            break;
         case Time::Sunrise:
-            dt = QDateTime(date, KHolidays::SunRiseSet::utcSunrise(date, context->m_latitude, context->m_longitude), Qt::UTC).toTimeZone(context->m_timezone);
+            t = KHolidays::SunRiseSet::utcSunrise(date, m_latitude, m_longitude);
             break;
         case Time::Dusk:
-            dt = QDateTime(date, KHolidays::SunRiseSet::utcDusk(date, context->m_latitude, context->m_longitude), Qt::UTC).toTimeZone(context->m_timezone);
+            t = KHolidays::SunRiseSet::utcDusk(date, m_latitude, m_longitude);
             break;
         case Time::Sunset:
-            dt = QDateTime(date, KHolidays::SunRiseSet::utcSunset(date, context->m_latitude, context->m_longitude), Qt::UTC).toTimeZone(context->m_timezone);
+            t = KHolidays::SunRiseSet::utcSunset(date, m_latitude, m_longitude);
             break;
     }
+    // wall clock time in the time zone of the expression
+    LocalDateTime result;
+    if (!t.isValid()) {
+        // no such event on that day, e.g. in polar regions
+    } else if (timezoneTable) {
+        // UTC wall clock time is the same as seconds since epoch
+        const auto utcSecs = LocalDateTime::fromSecsSinceEpoch(0).secsTo(LocalDateTime(date, t.msecsSinceStartOfDay() / 1000));
+        result = timezoneTable->toLocal(utcSecs);
+    } else {
+        result = LocalDateTime::fromDateTime(QDateTime(date, t, Qt::UTC).toTimeZone(m_timezone));
+    }
 
-    dt.setTimeSpec(Qt::LocalTime);
-    dt = dt.addSecs(t.hour * 3600 + t.minute * 60);
-    return dt;
+    QMutexLocker locker(&m_sunEventMutex);
+    m_timezoneTable = timezoneTable;
+    // about three years worth of days, more than typical iteration windows need
+    if (m_sunEvents.size() >= 1024) {
+        m_sunEvents.clear();
+    }
+    auto &entry = m_sunEvents[jd];
+    entry.events[idx] = result;
+    entry.resolved |= 1 << idx;
+    return result;
+}
+
+static LocalDateTime resolveTime(Time t, QDate date, OpeningHoursPrivate *context)
+{
+    if (t.event == Time::NoEvent) {
+        return LocalDateTime(date, t.hour % 24, t.minute);
+    }
+    return context->sunEvent(t.event, date).addSecs(t.hour * 3600 + t.minute * 60);
 }
 
 bool Timespan::isMultiDay(QDate date, OpeningHoursPrivate *context) const
@@ -58,7 +104,7 @@ bool Timespan::isMultiDay(QDate date, OpeningHoursPrivate *context) const
     return next ? next->isMultiDay(date, context) : false;
 }
 
-SelectorResult Timespan::nextInterval(const Interval &interval, const QDateTime &dt, OpeningHoursPrivate *context) const
+SelectorResult Timespan::nextInterval(const LocalInterval &interval, LocalDateTime dt, OpeningHoursPrivate *context) const
 {
     const auto beginDt = resolveTime(begin, dt.date(), context);
     const auto realEnd = adjustedEnd();
@@ -69,9 +115,9 @@ SelectorResult Timespan::nextInterval(const Interval &interval, const QDateTime
 
     if ((dt >= beginDt && dt < endDt) || (beginDt == endDt && beginDt == dt)) {
         auto i = interval;
-        i.setBegin(beginDt);
-        i.setEnd(endDt);
-        i.setOpenEndTime(openEnd);
+        i.begin = beginDt;
+        i.end = endDt;
+        i.openEndTime = openEnd;
         return i;
     }
 
@@ -104,16 +150,16 @@ static QDate nthWeekdayInMonth(QDate month, int weekDay, int n)
     }
 }
 
-SelectorResult WeekdayRange::nextInterval(const Interval &interval, const QDateTime &dt, OpeningHoursPrivate *context) const
+SelectorResult WeekdayRange::nextInterval(const LocalInterval &interval, LocalDateTime dt, OpeningHoursPrivate *context) const
 {
     SelectorResult r;
-    for (auto s = this; s; s = s->next.get()) {
+    for (auto s = this; s; s = s->next) {
         r = std::min(r, s->nextIntervalLocal(interval, dt, context));
     }
     return r;
 }
 
-SelectorResult WeekdayRange::nextIntervalLocal(const Interval &interval, const QDateTime &dt, OpeningHoursPrivate *context) const
+SelectorResult WeekdayRange::nextIntervalLocal(const LocalInterval &interval, LocalDateTime dt, OpeningHoursPrivate *context) const
 {
     if (lhsAndSelector && rhsAndSelector) {
         const auto r1 = lhsAndSelector->nextInterval(interval, dt, context);
@@ -127,8 +173,8 @@ SelectorResult WeekdayRange::nextIntervalLocal(const Interval &interval, const Q
         }
 
         auto i = r1.interval();
-        i.setBegin(std::max(i.begin(), r2.interval().begin()));
-        i.setEnd(std::min(i.end(), r2.interval().end()));
+        i.begin = std::max(i.begin, r2.interval().begin);
+        i.end = std::min(i.end, r2.interval().end);
         return i;
     }
 
@@ -146,12 +192,12 @@ SelectorResult WeekdayRange::nextIntervalLocal(const Interval &interval, const Q
                         }
                         if (d.addDays(offset) == dt.date()) {
                             auto i = interval;
-                            i.setBegin(QDateTime(d.addDays(offset), {0, 0}));
-                            i.setEnd(QDateTime(d.addDays(offset + 1), {0, 0}));
+                            i.begin = LocalDateTime(d.addDays(offset));
+                            i.end = LocalDateTime(d.addDays(offset + 1));
                             return i;
                         }
                         // d > dt.date()
-                        smallestOffset = qMin(smallestOffset, dt.secsTo(QDateTime(d.addDays(offset), {0, 0})));
+                        smallestOffset = qMin(smallestOffset, dt.secsTo(LocalDateTime(d.addDays(offset))));
                     }
                 }
                 if (smallestOffset < INT_MAX) {
@@ -159,46 +205,47 @@ SelectorResult WeekdayRange::nextIntervalLocal(const Interval &interval, const Q
                 }
 
                 // skip to next month
-                return dt.secsTo(QDateTime(dt.date().addDays(dt.date().daysTo({dt.date().year(), dt.date().month(), daysInMonth(dt.date().month())}) + 1 + offset) , {0, 0}));
+                return dt.secsTo(LocalDateTime(dt.date().addDays(dt.date().daysTo({dt.date().year(), dt.date().month(), daysInMonth(dt.date().month())}) + 1 + offset)));
             }
 
+            const auto dayOfWeek = dt.dayOfWeek();
             if (beginDay <= endDay) {
-                if (dt.date().dayOfWeek() < beginDay) {
-                    const auto d = beginDay - dt.date().dayOfWeek();
-                    return dt.secsTo(QDateTime(dt.date().addDays(d), {0, 0}));
+                if (dayOfWeek < beginDay) {
+                    const auto d = beginDay - dayOfWeek;
+                    return dt.secsTo(LocalDateTime(dt.date().addDays(d)));
                 }
-                if (dt.date().dayOfWeek() > endDay) {
-                    const auto d = 7 + beginDay - dt.date().dayOfWeek();
-                    return dt.secsTo(QDateTime(dt.date().addDays(d), {0, 0}));
+                if (dayOfWeek > endDay) {
+                    const auto d = 7 + beginDay - dayOfWeek;
+                    return dt.secsTo(LocalDateTime(dt.date().addDays(d)));
                 }
             } else {
-                if (dt.date().dayOfWeek() < beginDay && dt.date().dayOfWeek() > endDay) {
-                    const auto d = beginDay - dt.date().dayOfWeek();
-                    return dt.secsTo(QDateTime(dt.date().addDays(d), {0, 0}));
+                if (dayOfWeek < beginDay && dayOfWeek > endDay) {
+                    const auto d = beginDay - dayOfWeek;
+                    return dt.secsTo(LocalDateTime(dt.date().addDays(d)));
                 }
             }
 
             auto i = interval;
-            const auto d = beginDay - dt.date().dayOfWeek();
-            i.setBegin(QDateTime(dt.date().addDays(d), {0, 0}));
-            i.setEnd(QDateTime(i.begin().date().addDays(1 + (beginDay <= endDay ? endDay - beginDay : 7 - (beginDay - endDay))), {0, 0}));
+            const auto d = beginDay - dayOfWeek;
+            i.begin = LocalDateTime(dt.date().addDays(d));
+            i.end = LocalDateTime(i.begin.date().addDays(1 + (beginDay <= endDay ? endDay - beginDay : 7 - (beginDay - endDay))));
             return i;
         }
         case PublicHoliday:
         {
             const auto h = HolidayCache::nextHoliday(context->m_region, dt.date().addDays(-offset));
-            if (h.name().isEmpty()) {
+            if (!h.isValid()) {
                 return false;
             }
-            if (dt.date() < h.observedStartDate().addDays(offset)) {
-                return dt.secsTo(QDateTime(h.observedStartDate().addDays(offset), {0, 0}));
+            if (dt.date() < h.observedStart.addDays(offset)) {
+                return dt.secsTo(LocalDateTime(h.observedStart.addDays(offset)));
             }
 
             auto i = interval;
-            i.setBegin(QDateTime(h.observedStartDate().addDays(offset), {0, 0}));
-            i.setEnd(QDateTime(h.observedEndDate().addDays(1).addDays(offset), {0, 0}));
-            if (i.comment().isEmpty() && offset == 0) {
-                i.setComment(h.name());
+            i.begin = LocalDateTime(h.observedStart.addDays(offset));
+            i.end = LocalDateTime(h.observedEnd.addDays(1).addDays(offset));
+            if (i.comment == 0 && offset == 0) {
+                i.comment = h.name | LocalInterval::HolidayNameFlag;
             }
             return i;
         }
@@ -208,37 +255,41 @@ SelectorResult WeekdayRange::nextIntervalLocal(const Interval &interval, const Q
     return {};
 }
 
-SelectorResult Week::nextInterval(const Interval &interval, const QDateTime &dt, OpeningHoursPrivate *context) const
+SelectorResult Week::nextInterval(const LocalInterval &interval, LocalDateTime dt, OpeningHoursPrivate *context) const
 {
     Q_UNUSED(context);
-    if (dt.date().weekNumber() < beginWeek) {
-        const auto days = (7 - dt.date().dayOfWeek()) + 7 * (beginWeek - dt.date().weekNumber() - 1) + 1;
-        return dt.secsTo(QDateTime(dt.date().addDays(days), {0, 0}));
+    const auto date = dt.date();
+    const auto weekNumber = date.weekNumber();
+    if (weekNumber < beginWeek) {
+        const auto days = (7 - date.dayOfWeek()) + 7 * (beginWeek - weekNumber - 1) + 1;
+        return dt.secsTo(LocalDateTime(date.addDays(days)));
     }
-    if (dt.date().weekNumber() > endWeek) {
+    if (weekNumber > endWeek) {
         // "In accordance with ISO 8601, weeks start on Monday and the first Thursday of a year is always in week 1 of that year."
-        auto d = QDateTime({dt.date().year() + 1, 1, 1}, {0, 0});
-        while (d.date().weekNumber() != 1) {
+        auto d = QDate(date.year() + 1, 1, 1);
+        while (d.weekNumber() != 1) {
             d = d.addDays(1);
         }
-        return dt.secsTo(d);
+        return dt.secsTo(LocalDateTime(d));
     }
 
     if (this->interval > 1) {
-        const int wd = (dt.date().weekNumber() - beginWeek) % this->interval;
+        const int wd = (weekNumber - beginWeek) % this->interval;
         if (wd) {
-            const auto days = (7 - dt.date().dayOfWeek()) + 7 * (this->interval - wd - 1) + 1;
-            return dt.secsTo(QDateTime(dt.date().addDays(days), {0, 0}));
+            const auto days = (7 - date.dayOfWeek()) + 7 * (this->interval - wd - 1) + 1;
+            return dt.secsTo(LocalDateTime(date.addDays(days)));
         }
     }
 
     auto i = interval;
     if (this->interval > 1) {
-        i.setBegin(QDateTime(dt.date().addDays(1 - dt.date().dayOfWeek()), {0, 0}));
-        i.setEnd(QDateTime(i.begin().date().addDays(7), {0, 0}));
+        const auto beginDate = date.addDays(1 - date.dayOfWeek());
+        i.begin = LocalDateTime(beginDate);
+        i.end = LocalDateTime(beginDate.addDays(7));
     } else {
-        i.setBegin(QDateTime(dt.date().addDays(1 - dt.date().dayOfWeek() - 7 * (dt.date().weekNumber() - beginWeek)), {0, 0}));
-        i.setEnd(QDateTime(i.begin().date().addDays((1 + endWeek - beginWeek) * 7), {0, 0}));
+        const auto beginDate = date.addDays(1 - date.dayOfWeek() - 7 * (weekNumber - beginWeek));
+        i.begin = LocalDateTime(beginDate);
+        i.end = LocalDateTime(beginDate.addDays((1 + endWeek - beginWeek) * 7));
     }
     return i;
 }
@@ -280,7 +331,7 @@ static QDate resolveDateEnd(Date d, int year)
     return date.addDays(1);
 }
 
-SelectorResult MonthdayRange::nextInterval(const Interval &interval, const QDateTime &dt, OpeningHoursPrivate *context) const
+SelectorResult MonthdayRange::nextInterval(const LocalInterval &interval, LocalDateTime dt, OpeningHoursPrivate *context) const
 {
     Q_UNUSED(context);
     auto beginDt = resolveDate(begin, dt.date().year());
@@ -316,21 +367,21 @@ SelectorResult MonthdayRange::nextInterval(const Interval &interval, const QDate
     }
 
     if (dt.date() < beginDt) {
-        return dt.secsTo(QDateTime(beginDt, {0, 0}));
+        return dt.secsTo(LocalDateTime(beginDt));
     }
 
     auto i = interval;
-    i.setBegin(QDateTime(beginDt, {0, 0}));
-    i.setEnd(QDateTime(endDt, {0, 0}));
+    i.begin = LocalDateTime(beginDt);
+    i.end = LocalDateTime(endDt);
     return i;
 }
 
-SelectorResult YearRange::nextInterval(const Interval &interval, const QDateTime &dt, OpeningHoursPrivate *context) const
+SelectorResult YearRange::nextInterval(const LocalInterval &interval, LocalDateTime dt, OpeningHoursPrivate *context) const
 {
     Q_UNUSED(context);
     const auto y = dt.date().year();
     if (begin > y) {
-        return dt.secsTo(QDateTime({begin, 1, 1}, {0, 0}));
+        return dt.secsTo(LocalDateTime(QDate(begin, 1, 1)));
     }
     if (end > 0 && end < y) {
         return false;
@@ -339,22 +390,52 @@ SelectorResult YearRange::nextInterval(const Interval &interval, const QDateTime
     if (this->interval > 1) {
         const int yd = (y - begin) % this->interval;
         if (yd) {
-            return dt.secsTo(QDateTime({y + (this->interval - yd), 1, 1}, {0, 0}));
+            return dt.secsTo(LocalDateTime(QDate(y + (this->interval - yd), 1, 1)));
         }
     }
 
     auto i = interval;
     if (this->interval > 1) {
-        i.setBegin(QDateTime({y, 1, 1}, {0, 0}));
-        i.setEnd(QDateTime({y + 1, 1, 1}, {0, 0}));
+        i.begin = LocalDateTime(QDate(y, 1, 1));
+        i.end = LocalDateTime(QDate(y + 1, 1, 1));
     } else {
-        i.setBegin(QDateTime({begin, 1, 1}, {0, 0}));
-        i.setEnd(end > 0 ? QDateTime({end + 1, 1, 1}, {0, 0}) : QDateTime());
+        i.begin = LocalDateTime(QDate(begin, 1, 1));
+        i.end = end > 0 ? LocalDateTime(QDate(end + 1, 1, 1)) : LocalDateTime();
     }
     return i;
 }
 
-RuleResult Rule::nextInterval(const QDateTime &dt, OpeningHoursPrivate *context) const
+/** Latest (exclusive) end of the days matched by the selector chain starting at @p selector, invalid if unbounded. */
+template <typename T, typename F>
+static QDate selectorEndDate(const T *selector, F &&endDate)
+{
+    QDate result;
+    for (auto s = selector; s; s = s->next) {
+        const auto d = endDate(*s);
+        if (!d.isValid()) {
+            return {};
+        }
+        result = result.isValid() ? std::max(result, d) : d;
+    }
+    return result;
+}
+
+QDate Rule::endDate() const
+{
+    // same conditions as in the corresponding nextInterval implementations
+    const auto yearEnd = selectorEndDate(m_yearSelector, [](const YearRange &y) {
+        return y.end > 0 ? QDate(y.end + 1, 1, 1) : QDate();
+    });
+    const auto monthdayEnd = selectorEndDate(m_monthdaySelector, [](const MonthdayRange &m) {
+        return m.end.year ? resolveDateEnd(m.end, m.end.year) : QDate();
+    });
+    if (yearEnd.isValid() && monthdayEnd.isValid()) {
+        return std::min(yearEnd, monthdayEnd);
+    }
+    return yearEnd.isValid() ? yearEnd : monthdayEnd;
+}
+
+RuleResult Rule::nextInterval(LocalDateTime dt, OpeningHoursPrivate *context) const
 {
     // handle time selectors spanning midnight
     // consider e.g. "Tu 12:00-12:00" being evaluated with dt being Wednesday 08:00
@@ -370,82 +451,83 @@ RuleResult Rule::nextInterval(const QDateTime &dt, OpeningHoursPrivate *context)
     return nextInterval(dt, context, RecursionLimit);
 }
 
-RuleResult Rule::nextInterval(const QDateTime &dt, OpeningHoursPrivate *context, int recursionBudget) const
+/** Combined result of the selector chain starting at @p selector. */
+template <typename T>
+static SelectorResult nextSelectorInterval(const T *selector, const LocalInterval &interval, LocalDateTime dt, OpeningHoursPrivate *context)
 {
-    const auto resultMode = (recursionBudget == Rule::RecursionLimit && m_ruleType == NormalRule && state() != Interval::Closed) ? RuleResult::Override : RuleResult::Merge;
+    SelectorResult r;
+    for (auto s = selector; s; s = s->next) {
+        r = std::min(r, s->nextInterval(interval, dt, context));
+    }
+    return r;
+}
+
+RuleResult Rule::nextInterval(LocalDateTime dt, OpeningHoursPrivate *context, int recursionBudget) const
+{
+    auto resultMode = (recursionBudget == Rule::RecursionLimit && m_ruleType == NormalRule && state() != Interval::Closed) ? RuleResult::Override : RuleResult::Merge;
 
+    if (recursionBudget == Rule::RecursionLimit) {
+        StatisticsCollector::increment(StatisticsCollector::RuleEvaluationCount);
+    } else {
+        StatisticsCollector::recursionDepth(Rule::RecursionLimit - recursionBudget);
+    }
     if (recursionBudget == 0) {
+        StatisticsCollector::increment(StatisticsCollector::RecursionLimitCount);
         context->m_error = OpeningHours::EvaluationError;
         qCWarning(Log) << "Recursion limited reached!";
         return {{}, resultMode};
     }
 
-    Interval i;
-    i.setState(state());
-    i.setComment(m_comment);
+    LocalInterval i;
+    i.state = state();
+    i.comment = m_commentId;
     if (!m_timeSelector && !m_weekdaySelector && !m_monthdaySelector && !m_weekSelector && !m_yearSelector) {
         // 24/7 has no selectors
         return {i, resultMode};
     }
 
-    if (m_yearSelector) {
-        SelectorResult r;
-        for (auto s = m_yearSelector.get(); s; s = s->next.get()) {
-            r = std::min(r, s->nextInterval(i, dt, context));
-        }
-        if (!r.canMatch()) {
+    // find the first day matching all date selectors
+    // each selector that doesn't match tells us when it can match next at the earliest, so we can
+    // directly skip to the latest of those points and check all selectors again from there
+    for (int candidate = 0;; ++candidate) {
+        if (candidate == CandidateDayLimit) {
+            context->m_error = OpeningHours::EvaluationError;
+            qCWarning(Log) << "No matching day found within the candidate day limit!";
             return {{}, resultMode};
         }
-        if (r.matchOffset() > 0) {
-            return nextInterval(dt.addSecs(r.matchOffset()), context, --recursionBudget);
-        }
-        i = r.interval();
-    }
 
-    if (m_monthdaySelector) {
-        SelectorResult r;
-        for (auto s = m_monthdaySelector.get(); s; s = s->next.get()) {
-            r = std::min(r, s->nextInterval(i, dt, context));
-        }
-        if (!r.canMatch()) {
-            return {{}, resultMode};
-        }
-        if (r.matchOffset() > 0) {
-            return nextInterval(dt.addSecs(r.matchOffset()), context, --recursionBudget);
-        }
-        i = r.interval();
-    }
+        LocalInterval dayInterval = i;
+        int64_t skip = 0;
+        const auto apply = [&](const SelectorResult &r) {
+            if (!r.canMatch()) {
+                return false;
+            }
+            if (r.matchOffset() > 0) {
+                skip = std::max(skip, r.matchOffset());
+            } else if (skip == 0) {
+                dayInterval = r.interval();
+            }
+            return true;
+        };
 
-    if (m_weekSelector) {
-        SelectorResult r;
-        for (auto s = m_weekSelector.get(); s; s = s->next.get()) {
-            r = std::min(r, s->nextInterval(i, dt, context));
-        }
-        if (!r.canMatch()) {
+        if ((m_yearSelector && !apply(nextSelectorInterval(m_yearSelector, dayInterval, dt, context)))
+         || (m_monthdaySelector && !apply(nextSelectorInterval(m_monthdaySelector, dayInterval, dt, context)))
+         || (m_weekSelector && !apply(nextSelectorInterval(m_weekSelector, dayInterval, dt, context)))
+         || (m_weekdaySelector && !apply(m_weekdaySelector->nextInterval(dayInterval, dt, context)))) {
             return {{}, resultMode};
         }
-        if (r.matchOffset() > 0) {
-            return nextInterval(dt.addSecs(r.matchOffset()), context, --recursionBudget);
-        }
-        i = r.interval();
-    }
 
-    if (m_weekdaySelector) {
-        SelectorResult r = m_weekdaySelector->nextInterval(i, dt, context);
-        if (!r.canMatch()) {
-            return {{}, resultMode};
-        }
-        if (r.matchOffset() > 0) {
-            return nextInterval(dt.addSecs(r.matchOffset()), context, --recursionBudget);
+        if (skip == 0) {
+            i = dayInterval;
+            break;
         }
-        i = r.interval();
+        dt = dt.addSecs(skip);
+        // results not matching at the initial time are merged
+        resultMode = RuleResult::Merge;
     }
 
     if (m_timeSelector) {
-        SelectorResult r;
-        for (auto s = m_timeSelector.get(); s; s = s->next.get()) {
-            r = std::min(r, s->nextInterval(i, dt, context));
-        }
+        const auto r = nextSelectorInterval(m_timeSelector, i, dt, context);
         if (!r.canMatch()) {
             return {{}, resultMode};
         }
@@ -0,0 +1,119 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "expressioncache.h"
+#include "openinghours_p.h"
+
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+
+using namespace KOpeningHours;
+
+namespace KOpeningHours {
+struct ExpressionCacheKey {
+    QByteArray expression;
+    int modes;
+
+    inline bool operator==(const ExpressionCacheKey &other) const
+    {
+        return modes == other.modes && expression == other.expression;
+    }
+};
+
+using HashValue = decltype(qHash(QByteArray()));
+static inline HashValue qHash(const ExpressionCacheKey &key, HashValue seed = 0)
+{
+    return qHash(key.expression, seed) ^ static_cast<HashValue>(key.modes);
+}
+
+class ExpressionCachePrivate
+{
+public:
+    QMutex mutex;
+    QCache<ExpressionCacheKey, OpeningHours> cache;
+    quint64 hits = 0;
+    quint64 misses = 0;
+};
+}
+
+ExpressionCache::ExpressionCache(qsizetype maximumCost)
+    : d(new ExpressionCachePrivate)
+{
+    d->cache.setMaxCost(maximumCost);
+}
+
+ExpressionCache::~ExpressionCache() = default;
+
+OpeningHours ExpressionCache::get(const QByteArray &openingHours, OpeningHours::Modes modes)
+{
+    ExpressionCacheKey key{openingHours, static_cast<int>(modes)};
+    {
+        QMutexLocker locker(&d->mutex);
+        if (const auto oh = d->cache.object(key)) {
+            ++d->hits;
+            return *oh;
+        }
+        ++d->misses;
+    }
+
+    // parse without holding the lock, this is what takes time
+    OpeningHours oh(openingHours, modes);
+    oh.d->m_cached = true;
+    const auto cost = static_cast<qsizetype>(sizeof(OpeningHoursPrivate) + oh.d->m_arena->allocatedSize()) + openingHours.size();
+
+    QMutexLocker locker(&d->mutex);
+    // another thread might have been faster
+    if (const auto cachedOh = d->cache.object(key)) {
+        return *cachedOh;
+    }
+    d->cache.insert(key, new OpeningHours(oh), cost);
+    return oh;
+}
+
+qsizetype ExpressionCache::maximumCost() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->cache.maxCost();
+}
+
+void ExpressionCache::setMaximumCost(qsizetype maximumCost)
+{
+    QMutexLocker locker(&d->mutex);
+    d->cache.setMaxCost(maximumCost);
+}
+
+qsizetype ExpressionCache::totalCost() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->cache.totalCost();
+}
+
+qsizetype ExpressionCache::count() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->cache.count();
+}
+
+quint64 ExpressionCache::hitCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->hits;
+}
+
+quint64 ExpressionCache::missCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->misses;
+}
+
+void ExpressionCache::clear()
+{
+    QMutexLocker locker(&d->mutex);
+    d->cache.clear();
+    d->hits = 0;
+    d->misses = 0;
+}
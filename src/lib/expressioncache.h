@@ -0,0 +1,71 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_EXPRESSIONCACHE_H
+#define KOPENINGHOURS_EXPRESSIONCACHE_H
+
+#include "kopeninghours_export.h"
+#include "openinghours.h"
+
+#include <QtGlobal>
+
+#include <memory>
+
+namespace KOpeningHours {
+
+class ExpressionCachePrivate;
+
+/** Deduplicating cache of parsed opening hours expressions.
+ *  Large data sets typically contain the same few expressions many times, this avoids
+ *  parsing and validating those over and over again, as well as keeping multiple copies
+ *  of them in memory.
+ *
+ *  OpeningHours instances returned by this are shared with the cache and all other users
+ *  of the same expression. Unlike other OpeningHours instances they are copy-on-write though,
+ *  so changing their location, region or time zone doesn't affect other users, and still
+ *  doesn't duplicate the parsed expression.
+ *
+ *  When exceeding the maximum cost the least recently used entries are discarded.
+ *  All methods of this class are thread-safe.
+ */
+class KOPENINGHOURS_EXPORT ExpressionCache
+{
+public:
+    /** Creates a cache using up to @p maximumCost bytes of memory. */
+    explicit ExpressionCache(qsizetype maximumCost = 32 * 1024 * 1024);
+    ~ExpressionCache();
+
+    /** Returns the parsed expression @p openingHours, parsing it only if not already cached.
+     *  This behaves like the corresponding OpeningHours constructor otherwise.
+     */
+    OpeningHours get(const QByteArray &openingHours, OpeningHours::Modes modes = OpeningHours::IntervalMode);
+
+    /** Approximate maximum memory use of the cache, in bytes. */
+    qsizetype maximumCost() const;
+    void setMaximumCost(qsizetype maximumCost);
+    /** Approximate current memory use of the cache, in bytes. */
+    qsizetype totalCost() const;
+    /** Amount of cached expressions. */
+    qsizetype count() const;
+
+    /** Amount of get() calls that were answered from the cache. */
+    quint64 hitCount() const;
+    /** Amount of get() calls that had to parse the expression. */
+    quint64 missCount() const;
+
+    /** Discards all cached expressions and resets the hit and miss counters.
+     *  Previously returned OpeningHours instances remain valid.
+     */
+    void clear();
+
+private:
+    Q_DISABLE_COPY(ExpressionCache)
+    std::unique_ptr<ExpressionCachePrivate> d;
+};
+
+}
+
+#endif // KOPENINGHOURS_EXPRESSIONCACHE_H
@@ -0,0 +1,230 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "fastparser_p.h"
+#include "openinghours_p.h"
+
+#include <cstring>
+
+using namespace KOpeningHours;
+
+// anything more complex than that is left to the full parser
+enum { MaxRules = 16, MaxSelectors = 8 };
+
+namespace {
+struct ParsedWeekday {
+    uint8_t beginDay;
+    uint8_t endDay;
+    bool holiday;
+};
+
+struct ParsedRule {
+    ParsedWeekday weekdays[MaxSelectors];
+    int weekdayCount = 0;
+    Time times[MaxSelectors][2];
+    int timeCount = 0;
+    State state = State::Open;
+    bool hasState = false;
+    bool seen_24_7 = false;
+};
+
+class Scanner
+{
+public:
+    inline bool atEnd() const { return m_it == m_end; }
+    inline bool consume(char c)
+    {
+        if (m_it != m_end && *m_it == c) {
+            ++m_it;
+            return true;
+        }
+        return false;
+    }
+    /** Consumes @p word if it is followed by a rule separator or the end of the input. */
+    bool consumeWord(const char *word);
+    inline bool atDigit() const { return m_it != m_end && *m_it >= '0' && *m_it <= '9'; }
+    inline bool atLetter() const { return m_it != m_end && *m_it >= 'A' && *m_it <= 'Z'; }
+    /** Checks whether the current rule ends here. */
+    inline bool atRuleEnd() const { return atEnd() || *m_it == ';'; }
+
+    bool parseWeekday(ParsedWeekday &weekday);
+    bool parseTime(Time &time);
+    bool parseState(State &state);
+    bool parseRule(ParsedRule &rule);
+
+    const char *m_it;
+    const char *m_end;
+};
+}
+
+bool Scanner::consumeWord(const char *word)
+{
+    const auto len = std::strlen(word);
+    if (std::size_t(m_end - m_it) < len || std::memcmp(m_it, word, len) != 0) {
+        return false;
+    }
+    const auto it = m_it;
+    m_it += len;
+    if (atRuleEnd()) {
+        return true;
+    }
+    m_it = it;
+    return false;
+}
+
+bool Scanner::parseWeekday(ParsedWeekday &weekday)
+{
+    static constexpr const char weekdays[] = "MoTuWeThFrSaSu";
+    const auto parseDay = [this](uint8_t &day) {
+        if (m_end - m_it < 2) {
+            return false;
+        }
+        for (int i = 0; i < 7; ++i) {
+            if (m_it[0] == weekdays[2 * i] && m_it[1] == weekdays[2 * i + 1]) {
+                m_it += 2;
+                day = i + 1;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (m_end - m_it >= 2 && m_it[0] == 'P' && m_it[1] == 'H') {
+        m_it += 2;
+        weekday.holiday = true;
+    } else {
+        weekday.holiday = false;
+        if (!parseDay(weekday.beginDay)) {
+            return false;
+        }
+        weekday.endDay = weekday.beginDay;
+        if (consume('-') && !parseDay(weekday.endDay)) {
+            return false;
+        }
+    }
+    // longer weekday names, holiday offsets, nth selectors, etc
+    return atRuleEnd() || *m_it == ',' || *m_it == ' ';
+}
+
+bool Scanner::parseTime(Time &time)
+{
+    if (m_end - m_it < 5 || !atDigit() || m_it[2] != ':') {
+        return false;
+    }
+    const auto digit = [this](int i) { return m_it[i] >= '0' && m_it[i] <= '9' ? m_it[i] - '0' : -100; };
+    time = { Time::NoEvent, digit(0) * 10 + digit(1), digit(3) * 10 + digit(4) };
+    m_it += 5;
+    return Time::isValid(time);
+}
+
+bool Scanner::parseState(State &state)
+{
+    if (consumeWord("off")) {
+        state = State::Off;
+    } else if (consumeWord("closed")) {
+        state = State::Closed;
+    } else if (consumeWord("open")) {
+        state = State::Open;
+    } else if (consumeWord("unknown")) {
+        state = State::Unknown;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool Scanner::parseRule(ParsedRule &rule)
+{
+    bool hasSelector = false;
+    if (m_end - m_it >= 4 && std::memcmp(m_it, "24/7", 4) == 0) {
+        m_it += 4;
+        rule.seen_24_7 = true;
+        hasSelector = true;
+    } else if (atLetter()) {
+        do {
+            if (rule.weekdayCount == MaxSelectors || !parseWeekday(rule.weekdays[rule.weekdayCount++])) {
+                return false;
+            }
+        } while (consume(','));
+        hasSelector = true;
+    }
+    if (hasSelector && !consume(' ')) {
+        return atRuleEnd();
+    }
+
+    if (atDigit() && !rule.seen_24_7) {
+        do {
+            if (rule.timeCount == MaxSelectors) {
+                return false;
+            }
+            auto &t = rule.times[rule.timeCount++];
+            if (!parseTime(t[0]) || !consume('-') || !parseTime(t[1])) {
+                return false;
+            }
+        } while (consume(','));
+        if (!consume(' ')) {
+            return atRuleEnd();
+        }
+    }
+
+    rule.hasState = parseState(rule.state);
+    return rule.hasState;
+}
+
+bool FastParser::parse(OpeningHoursPrivate *parser, const char *expr, std::size_t size)
+{
+    Scanner scanner{ expr, expr + size };
+    ParsedRule rules[MaxRules];
+    int ruleCount = 0;
+    for (;;) {
+        if (ruleCount == MaxRules || !scanner.parseRule(rules[ruleCount++])) {
+            return false;
+        }
+        if (scanner.atEnd()) {
+            break;
+        }
+        if (!scanner.consume(';') || !scanner.consume(' ')) {
+            return false;
+        }
+    }
+
+    // same structure as created by the full parser
+    for (int i = 0; i < ruleCount; ++i) {
+        const auto &r = rules[i];
+        auto rule = parser->m_arena->create<Rule>();
+        if (r.hasState) {
+            rule->setState(r.state);
+        }
+        rule->m_seen_24_7 = r.seen_24_7;
+        for (int j = 0; j < r.weekdayCount; ++j) {
+            auto sel = parser->m_arena->create<WeekdayRange>();
+            if (r.weekdays[j].holiday) {
+                sel->holiday = WeekdayRange::PublicHoliday;
+            } else {
+                sel->beginDay = r.weekdays[j].beginDay;
+                sel->endDay = r.weekdays[j].endDay;
+            }
+            if (rule->m_weekdaySelector) {
+                appendSelector(rule->m_weekdaySelector, sel);
+            } else {
+                rule->m_weekdaySelector = sel;
+            }
+        }
+        for (int j = 0; j < r.timeCount; ++j) {
+            auto sel = parser->m_arena->create<Timespan>();
+            sel->begin = r.times[j][0];
+            sel->end = r.times[j][1];
+            if (rule->m_timeSelector) {
+                appendSelector(rule->m_timeSelector, sel);
+            } else {
+                rule->m_timeSelector = sel;
+            }
+        }
+        parser->addRule(rule);
+    }
+    parser->m_error = OpeningHours::NoError;
+    return true;
+}
@@ -0,0 +1,33 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_FASTPARSER_P_H
+#define KOPENINGHOURS_FASTPARSER_P_H
+
+#include <cstddef>
+
+namespace KOpeningHours {
+
+class OpeningHoursPrivate;
+
+/** Recognizer for the strictly canonical form of the most common simple expressions.
+ *  This covers normal rule sequences consisting of 24/7, two-letter weekday ranges, PH,
+ *  hh:mm-hh:mm time spans and a rule modifier, such as "Mo-Fr 08:00-18:00; Sa 10:00-14:00; PH off".
+ *  Those are the majority of expressions in real data, and turn into the exact same rules
+ *  as the full parser would produce, at a fraction of the cost of the scanner and parser.
+ */
+namespace FastParser
+{
+    /** Parses @p expr and adds the resulting rules to @p parser.
+     *  Returns @c false without modifying @p parser if @p expr isn't covered by this and
+     *  needs the full parser.
+     */
+    bool parse(OpeningHoursPrivate *parser, const char *expr, std::size_t size);
+}
+
+}
+
+#endif // KOPENINGHOURS_FASTPARSER_P_H
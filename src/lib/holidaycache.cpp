@@ -5,18 +5,32 @@
 */
 
 #include "holidaycache_p.h"
+#include "logging.h"
+#include "statistics_p.h"
 
 #include <kholidays_version.h>
 #include <KHolidays/HolidayRegion>
 
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QDate>
+#include <QDirIterator>
+#include <QFile>
 #include <QHash>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
 
 using namespace KOpeningHours;
 
 KHolidays::HolidayRegion HolidayCache::resolveRegion(QStringView region)
 {
     static QHash<QString, QString> s_holidayRegionCache;
+    static QReadWriteLock s_holidayRegionCacheLock;
 
     const auto idx = region.indexOf(QLatin1Char('_')); // compatibility with KHolidays region codes
     if (idx > 0) {
@@ -25,62 +39,365 @@ KHolidays::HolidayRegion HolidayCache::resolveRegion(QStringView region)
 
     const auto loc = region.toString();
 
-    const auto it = s_holidayRegionCache.constFind(loc);
-    if (it != s_holidayRegionCache.constEnd()) {
-        return KHolidays::HolidayRegion(it.value());
+    {
+        QReadLocker locker(&s_holidayRegionCacheLock);
+        const auto it = s_holidayRegionCache.constFind(loc);
+        if (it != s_holidayRegionCache.constEnd()) {
+            return KHolidays::HolidayRegion(it.value());
+        }
     }
 
-    const auto code = KHolidays::HolidayRegion::defaultRegionCode(loc);
-    s_holidayRegionCache.insert(loc, code);
-    return KHolidays::HolidayRegion(code);
+    QWriteLocker locker(&s_holidayRegionCacheLock);
+    auto it = s_holidayRegionCache.constFind(loc);
+    if (it == s_holidayRegionCache.constEnd()) {
+        it = s_holidayRegionCache.insert(loc, KHolidays::HolidayRegion::defaultRegionCode(loc));
+    }
+    return KHolidays::HolidayRegion(it.value());
 }
 
+namespace {
+/** Compact holiday representation, dates are Julian days. */
+struct CompactHoliday {
+    inline bool operator==(const CompactHoliday &other) const
+    {
+        return observedStart == other.observedStart && observedEnd == other.observedEnd && nameIndex == other.nameIndex;
+    }
+
+    int observedStart;
+    int observedEnd;
+    int nameIndex;
+};
+
 struct HolidayCacheEntry {
     QDate begin;
     QDate end;
-    KHolidays::Holiday::List holidays;
+    std::vector<CompactHoliday> holidays; // sorted by observed start date
+    std::vector<StringPool::Id> names;
 };
 
-static KHolidays::Holiday nextHoliday(const KHolidays::Holiday::List &holidays, QDate date)
+using HolidayCacheEntryPtr = std::shared_ptr<const HolidayCacheEntry>;
+using HolidayCacheSnapshot = QHash<QString, HolidayCacheEntryPtr>;
+
+/** One shard of the holiday cache.
+ *  Readers never block, they atomically obtain the current immutable snapshot of the shard content.
+ *  Writers are serialized per shard, and publish a new snapshot once they are done. This also
+ *  ensures KHolidays is never queried concurrently for the same region.
+ */
+struct HolidayCacheShard {
+    QMutex writeLock;
+    std::shared_ptr<const HolidayCacheSnapshot> snapshot = std::make_shared<HolidayCacheSnapshot>();
+};
+
+enum { HolidayCacheShardCount = 16 };
+}
+
+static HolidayCacheShard& holidayCacheShardByIndex(int index)
+{
+    static HolidayCacheShard s_holidayCache[HolidayCacheShardCount];
+    return s_holidayCache[index];
+}
+
+static HolidayCacheShard& holidayCacheShard(const QString &regionCode)
+{
+    return holidayCacheShardByIndex(qHash(regionCode) % HolidayCacheShardCount);
+}
+
+static HolidayCacheEntryPtr findEntry(const HolidayCacheShard &shard, const QString &regionCode)
+{
+    const auto snapshot = std::atomic_load(&shard.snapshot);
+    return snapshot->value(regionCode);
+}
+
+static bool entryCoversDate(const HolidayCacheEntryPtr &entry, QDate date)
+{
+    return entry && date >= entry->begin && date.addYears(1) < entry->end;
+}
+
+static bool holidayStartLessThan(const CompactHoliday &lhs, const CompactHoliday &rhs)
+{
+    return lhs.observedStart < rhs.observedStart;
+}
+
+static int nameIndex(HolidayCacheEntry &entry, const QString &name)
 {
+    const auto id = StringPool::intern(name);
+    const auto it = std::find(entry.names.begin(), entry.names.end(), id);
+    if (it != entry.names.end()) {
+        return static_cast<int>(std::distance(entry.names.begin(), it));
+    }
+    entry.names.push_back(id);
+    return static_cast<int>(entry.names.size()) - 1;
+}
+
+/** Adds holidays between @p begin and @p end to @p entry, keeping the holiday list sorted. */
+static void addHolidays(HolidayCacheEntry &entry, const KHolidays::HolidayRegion &region, QDate begin, QDate end)
+{
+#if KHOLIDAYS_VERSION >= QT_VERSION_CHECK(5, 95, 0)
+    const auto holidays = region.rawHolidays(begin, end);
+#else
+    const auto holidays = region.holidays(begin, end);
+#endif
+    StatisticsCollector::increment(StatisticsCollector::HolidayCacheRefills);
+
+    const auto prevSize = entry.holidays.size();
     for (const auto &h : holidays) {
-        if (h.observedStartDate() >= date)
-            return h;
+        if (h.dayType() != KHolidays::Holiday::NonWorkday) {
+            continue;
+        }
+        entry.holidays.push_back({ static_cast<int>(h.observedStartDate().toJulianDay()), static_cast<int>(h.observedEndDate().toJulianDay()), nameIndex(entry, h.name()) });
+    }
+    const auto mid = std::next(entry.holidays.begin(), prevSize);
+    std::stable_sort(mid, entry.holidays.end(), holidayStartLessThan);
+    std::inplace_merge(entry.holidays.begin(), mid, entry.holidays.end(), holidayStartLessThan);
+
+    // remove duplicates from holidays overlapping with the boundary of the previously cached range
+    std::vector<CompactHoliday> merged;
+    merged.reserve(entry.holidays.size());
+    for (const auto &h : entry.holidays) {
+        const auto isDuplicate = [&merged, &h]() {
+            for (auto it = merged.rbegin(); it != merged.rend() && (*it).observedStart == h.observedStart; ++it) {
+                if (*it == h) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        if (!isDuplicate()) {
+            merged.push_back(h);
+        }
+    }
+    entry.holidays = std::move(merged);
+}
+
+static HolidayCache::Holiday nextHoliday(const HolidayCacheEntry &entry, QDate date)
+{
+    const auto it = std::lower_bound(entry.holidays.begin(), entry.holidays.end(), date.toJulianDay(), [](const CompactHoliday &h, qint64 jd) {
+        return h.observedStart < jd;
+    });
+    if (it == entry.holidays.end()) {
+        return {};
     }
-    return {};
+    return { QDate::fromJulianDay((*it).observedStart), QDate::fromJulianDay((*it).observedEnd), entry.names[(*it).nameIndex] };
 }
 
-KHolidays::Holiday HolidayCache::nextHoliday(const KHolidays::HolidayRegion &region, QDate date)
+/** Makes sure the cache entry for @p region covers [@p begin, @p end), fetching missing holidays as needed.
+ *  Must be called with the write lock of @p shard held.
+ */
+static HolidayCacheEntryPtr extendEntry(HolidayCacheShard &shard, const KHolidays::HolidayRegion &region, const QString &regionCode, const HolidayCacheEntryPtr &entry, QDate begin, QDate end)
 {
-    static QHash<QString, HolidayCacheEntry> s_holidayCache;
+    // extend the cached range by only fetching what's missing
+    std::shared_ptr<HolidayCacheEntry> newEntry;
+    if (entry) {
+        if (begin >= entry->begin && end <= entry->end) {
+            return entry;
+        }
+        newEntry = std::make_shared<HolidayCacheEntry>(*entry);
+        if (begin < entry->begin) {
+            addHolidays(*newEntry, region, begin, entry->begin);
+            newEntry->begin = begin;
+        }
+        if (end > entry->end) {
+            addHolidays(*newEntry, region, entry->end, end);
+            newEntry->end = end;
+        }
+    } else {
+        newEntry = std::make_shared<HolidayCacheEntry>();
+        addHolidays(*newEntry, region, begin, end);
+        newEntry->begin = begin;
+        newEntry->end = end;
+    }
+
+    auto snapshot = std::make_shared<HolidayCacheSnapshot>(*std::atomic_load(&shard.snapshot));
+    snapshot->insert(regionCode, newEntry);
+    std::atomic_store(&shard.snapshot, std::shared_ptr<const HolidayCacheSnapshot>(std::move(snapshot)));
+    return newEntry;
+}
 
+HolidayCache::Holiday HolidayCache::nextHoliday(const KHolidays::HolidayRegion &region, QDate date)
+{
     if (!region.isValid()) {
         return {};
     }
 
-    const auto it = s_holidayCache.constFind(region.regionCode());
-    if (it != s_holidayCache.constEnd() && date >= it.value().begin && date.addYears(1) < it.value().end) {
-        return nextHoliday(it.value().holidays, date);
+    const auto regionCode = region.regionCode();
+    auto &shard = holidayCacheShard(regionCode);
+    auto entry = findEntry(shard, regionCode);
+    if (entryCoversDate(entry, date)) {
+        StatisticsCollector::increment(StatisticsCollector::HolidayCacheHits);
+        return ::nextHoliday(*entry, date);
     }
 
-    HolidayCacheEntry entry;
-    entry.begin = date.addDays(-7);
-    entry.end = date.addYears(2).addDays(7);
-    if (it != s_holidayCache.constEnd()) {
-        entry.begin = std::min(it.value().begin, entry.begin);
-        entry.end = std::max(it.value().end, entry.end);
+    StatisticsCollector::increment(StatisticsCollector::HolidayCacheMisses);
+    QMutexLocker locker(&shard.writeLock);
+    // check again if another thread filled this while we were waiting for the lock
+    entry = findEntry(shard, regionCode);
+    if (entryCoversDate(entry, date)) {
+        return ::nextHoliday(*entry, date);
     }
-#if KHOLIDAYS_VERSION >= QT_VERSION_CHECK(5, 95, 0)
-    entry.holidays = region.rawHolidays(entry.begin, entry.end);
-#else
-    entry.holidays = region.holidays(entry.begin, entry.end);
-#endif
-    entry.holidays.erase(std::remove_if(entry.holidays.begin(), entry.holidays.end(), [](const auto &h) {
-        return h.dayType() != KHolidays::Holiday::NonWorkday;
-    }), entry.holidays.end());
-    std::sort(entry.holidays.begin(), entry.holidays.end(), [](const auto &lhs, const auto &rhs) {
-        return lhs.observedStartDate() < rhs.observedStartDate();
-    });
-    s_holidayCache.insert(region.regionCode(), entry);
-    return nextHoliday(entry.holidays, date);
+
+    entry = extendEntry(shard, region, regionCode, entry, date.addDays(-7), date.addYears(2).addDays(7));
+    return ::nextHoliday(*entry, date);
+}
+
+void HolidayCache::prewarm(QStringView region, int beginYear, int endYear)
+{
+    const auto holidayRegion = resolveRegion(region);
+    if (!holidayRegion.isValid() || endYear < beginYear) {
+        return;
+    }
+
+    // same margins as used by nextHoliday(), so that lookups for any day in the range are cache hits
+    const auto regionCode = holidayRegion.regionCode();
+    auto &shard = holidayCacheShard(regionCode);
+    QMutexLocker locker(&shard.writeLock);
+    extendEntry(shard, holidayRegion, regionCode, findEntry(shard, regionCode), QDate(beginYear, 1, 1).addDays(-7), QDate(endYear + 2, 1, 1).addDays(7));
+}
+
+// cache file format, all data is in QDataStream encoding:
+// magic, format version, KHolidays version, number of entries,
+// followed by per entry: region code, region data hash, begin and end date, holidays, holiday names
+static constexpr quint32 CacheFileMagic = 0x4b4f4843; // "KOHC"
+static constexpr quint32 CacheFileFormatVersion = 2;
+static constexpr auto CacheFileStreamVersion = QDataStream::Qt_5_12;
+
+/** Holiday definition files embedded in KHolidays, by region code.
+ *  KHolidays doesn't expose the file used for a region, but names them "holiday_<region code>".
+ *  The directory layout inside its resources differs between versions, so this searches all of them.
+ */
+static QHash<QString, QString> regionDataFiles()
+{
+    QHash<QString, QString> files;
+    const auto prefix = QLatin1String("holiday_");
+    QDirIterator it(QStringLiteral(":/org.kde.kholidays"), { prefix + QLatin1Char('*') }, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const auto path = it.next();
+        files.insert(it.fileName().mid(prefix.size()), path);
+    }
+    return files;
+}
+
+/** Hash of the holiday definitions KHolidays uses for @p regionCode.
+ *  KHolidays has no way to query its version at runtime, but it embeds the holiday definitions
+ *  into the library, so this catches a different library being used at runtime than at build time,
+ *  as well as changes to the holiday data between KHolidays releases.
+ *  Empty if the holiday definitions cannot be found.
+ */
+static QByteArray regionDataHash(const QString &regionCode)
+{
+    static const auto s_regionDataFiles = regionDataFiles();
+    QFile f(s_regionDataFiles.value(regionCode));
+    if (f.fileName().isEmpty() || !f.open(QFile::ReadOnly)) {
+        qCWarning(Log) << "Holiday definitions not found for" << regionCode;
+        return {};
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&f);
+    return hash.result();
+}
+
+bool HolidayCache::loadFromFile(const QString &fileName)
+{
+    QFile f(fileName);
+    if (!f.open(QFile::ReadOnly)) {
+        return false;
+    }
+    // the content is converted into our in-memory representation while reading anyway,
+    // so there is nothing to gain from mapping the file here
+    const auto size = f.size();
+    QDataStream stream(&f);
+    stream.setVersion(CacheFileStreamVersion);
+
+    quint32 magic = 0, formatVersion = 0, kholidaysVersion = 0, entryCount = 0;
+    stream >> magic >> formatVersion >> kholidaysVersion >> entryCount;
+    if (magic != CacheFileMagic || formatVersion != CacheFileFormatVersion || kholidaysVersion != KHOLIDAYS_VERSION) {
+        return false;
+    }
+
+    std::vector<std::pair<QString, HolidayCacheEntryPtr>> entries;
+    bool upToDate = true;
+    for (quint32 i = 0; i < entryCount && stream.status() == QDataStream::Ok; ++i) {
+        QString regionCode;
+        QByteArray dataHash;
+        auto entry = std::make_shared<HolidayCacheEntry>();
+        quint32 holidayCount = 0;
+        stream >> regionCode >> dataHash >> entry->begin >> entry->end >> holidayCount;
+        if (stream.status() != QDataStream::Ok || holidayCount > size / (3 * sizeof(qint32))) {
+            return false;
+        }
+        entry->holidays.resize(holidayCount);
+        for (auto &h : entry->holidays) {
+            qint32 start, end, nameIdx;
+            stream >> start >> end >> nameIdx;
+            h = { start, end, nameIdx };
+        }
+        quint32 nameCount = 0;
+        stream >> nameCount;
+        if (stream.status() != QDataStream::Ok || nameCount > size) {
+            return false;
+        }
+        entry->names.resize(nameCount);
+        for (auto &nameId : entry->names) {
+            QString name;
+            stream >> name;
+            nameId = StringPool::intern(name);
+        }
+        const auto validHoliday = [&entry](const CompactHoliday &h) { return h.nameIndex >= 0 && h.nameIndex < static_cast<int>(entry->names.size()); };
+        if (stream.status() != QDataStream::Ok || !entry->begin.isValid() || !entry->end.isValid()
+            || !std::all_of(entry->holidays.begin(), entry->holidays.end(), validHoliday)
+            || !std::is_sorted(entry->holidays.begin(), entry->holidays.end(), holidayStartLessThan)) {
+            return false;
+        }
+        // holidays of regions with changed or unknown holiday definitions are obtained from KHolidays again
+        if (dataHash.isEmpty() || dataHash != regionDataHash(regionCode)) {
+            upToDate = false;
+            continue;
+        }
+        entries.emplace_back(regionCode, std::move(entry));
+    }
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // entries already in memory are at least as up to date as what we loaded
+    for (const auto &entry : entries) {
+        auto &shard = holidayCacheShard(entry.first);
+        QMutexLocker locker(&shard.writeLock);
+        if (findEntry(shard, entry.first)) {
+            continue;
+        }
+        auto snapshot = std::make_shared<HolidayCacheSnapshot>(*std::atomic_load(&shard.snapshot));
+        snapshot->insert(entry.first, entry.second);
+        std::atomic_store(&shard.snapshot, std::shared_ptr<const HolidayCacheSnapshot>(std::move(snapshot)));
+    }
+    return upToDate;
+}
+
+bool HolidayCache::saveToFile(const QString &fileName)
+{
+    std::vector<std::pair<QString, HolidayCacheEntryPtr>> entries;
+    for (int i = 0; i < HolidayCacheShardCount; ++i) {
+        const auto snapshot = std::atomic_load(&holidayCacheShardByIndex(i).snapshot);
+        for (auto it = snapshot->begin(); it != snapshot->end(); ++it) {
+            entries.emplace_back(it.key(), it.value());
+        }
+    }
+
+    QSaveFile f(fileName);
+    if (!f.open(QFile::WriteOnly)) {
+        return false;
+    }
+    QDataStream stream(&f);
+    stream.setVersion(CacheFileStreamVersion);
+    stream << CacheFileMagic << CacheFileFormatVersion << static_cast<quint32>(KHOLIDAYS_VERSION) << static_cast<quint32>(entries.size());
+    for (const auto &entry : entries) {
+        stream << entry.first << regionDataHash(entry.first) << entry.second->begin << entry.second->end << static_cast<quint32>(entry.second->holidays.size());
+        for (const auto &h : entry.second->holidays) {
+            stream << static_cast<qint32>(h.observedStart) << static_cast<qint32>(h.observedEnd) << static_cast<qint32>(h.nameIndex);
+        }
+        stream << static_cast<quint32>(entry.second->names.size());
+        for (const auto nameId : entry.second->names) {
+            stream << StringPool::string(nameId);
+        }
+    }
+    return stream.status() == QDataStream::Ok && f.commit();
 }
@@ -7,14 +7,15 @@
 #ifndef KOPENINGHOURS_HOLIDAYCACHE_P_H
 #define KOPENINGHOURS_HOLIDAYCACHE_P_H
 
+#include "stringpool_p.h"
+
+#include <QDate>
+#include <QString>
+
 namespace KHolidays {
-class Holiday;
 class HolidayRegion;
 }
 
-class QDate;
-class QStringView;
-
 namespace KOpeningHours {
 
 /** Cache of holiday region lookups, and holidays for holiday regions
@@ -22,11 +23,30 @@ namespace KOpeningHours {
  */
 namespace HolidayCache
 {
+    /** Holiday information as needed for evaluation. */
+    struct Holiday {
+        inline bool isValid() const { return observedStart.isValid(); }
+
+        QDate observedStart;
+        QDate observedEnd;
+        StringPool::Id name = 0;
+    };
+
     /** Find KHoliday region for a given ISO 3166-1/2 code. */
     KHolidays::HolidayRegion resolveRegion(QStringView region);
 
     /** Returns the next holiday at or after @p dt in the given holiday region. */
-    KHolidays::Holiday nextHoliday(const KHolidays::HolidayRegion &region, QDate date);
+    Holiday nextHoliday(const KHolidays::HolidayRegion &region, QDate date);
+
+    /** Loads holidays for ISO 3166-1/2 code @p region from @p beginYear until @p endYear (inclusive). */
+    void prewarm(QStringView region, int beginYear, int endYear);
+    /** Adds holiday data for regions not cached yet from @p fileName.
+     *  Files written with a different KHolidays version are rejected, as are entries for regions
+     *  whose holiday definitions changed since or cannot be found, in both cases @c false is returned.
+     */
+    bool loadFromFile(const QString &fileName);
+    /** Writes the content of the cache to @p fileName. */
+    bool saveToFile(const QString &fileName);
 }
 
 }
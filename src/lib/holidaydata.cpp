@@ -0,0 +1,29 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "holidaydata.h"
+#include "holidaycache_p.h"
+
+#include <QStringList>
+
+using namespace KOpeningHours;
+
+void HolidayData::prewarm(const QStringList &regions, int beginYear, int endYear)
+{
+    for (const auto &region : regions) {
+        HolidayCache::prewarm(region, beginYear, endYear);
+    }
+}
+
+bool HolidayData::loadCache(const QString &fileName)
+{
+    return HolidayCache::loadFromFile(fileName);
+}
+
+bool HolidayData::saveCache(const QString &fileName)
+{
+    return HolidayCache::saveToFile(fileName);
+}
@@ -0,0 +1,45 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_HOLIDAYDATA_H
+#define KOPENINGHOURS_HOLIDAYDATA_H
+
+#include "kopeninghours_export.h"
+
+class QString;
+class QStringList;
+
+namespace KOpeningHours {
+
+/** Control over the process-wide public holiday data cache.
+ *  Holiday data is loaded on demand during evaluation, which is comparatively expensive
+ *  and happens again in every process. Short-lived processes evaluating expressions
+ *  for many regions can use this to load the holiday data upfront, or to reuse
+ *  holiday data across processes via a cache file.
+ *  All methods of this class are thread-safe.
+ */
+class KOPENINGHOURS_EXPORT HolidayData
+{
+public:
+    /** Load holidays from @p beginYear until @p endYear (inclusive) for all of @p regions.
+     *  @param regions ISO 3166-2 region or ISO 3166-1 country codes, as for OpeningHours::setRegion().
+     */
+    static void prewarm(const QStringList &regions, int beginYear, int endYear);
+
+    /** Add holiday data stored in the cache file @p fileName.
+     *  Regions already loaded in this process are not affected.
+     *  Holiday data of regions whose holiday definitions changed since the file was written is ignored.
+     *  @returns @c false if the file cannot be read, or was written by a different version of
+     *  the holiday data, in which case it should be written again with saveCache().
+     */
+    static bool loadCache(const QString &fileName);
+    /** Write all holiday data loaded so far to the cache file @p fileName. */
+    static bool saveCache(const QString &fileName);
+};
+
+}
+
+#endif // KOPENINGHOURS_HOLIDAYDATA_H
@@ -5,34 +5,80 @@
 */
 
 #include "intervalmodel.h"
+#include "openinghours_p.h"
 
 #include <KOpeningHours/Display>
 #include <KOpeningHours/Interval>
 
+#include <QCache>
 #include <QLocale>
+#include <QMutex>
+#include <QRunnable>
+#include <QThreadPool>
 
+#include <memory>
 #include <vector>
 
 using namespace KOpeningHours;
 
 namespace KOpeningHours {
 
-struct DayData {
-    QDate day;
-    std::vector<Interval> intervals;
+/** Lets prefetch jobs deliver their results only while the model still exists. */
+struct PrefetchGuard {
+    QMutex mutex;
+    IntervalModel *model = nullptr;
 };
 
 class IntervalModelPrivate {
 public:
     void repopulateModel();
-
+    int rowCount() const;
+    QDate day(int row) const;
+    /** Intervals of @p row, computed on demand. */
+    const std::vector<Interval>& intervals(int row);
+    void prefetch(int row);
+    /** Copy of oh not shared with the caller, for evaluation on another thread. */
+    OpeningHours privateCopy() const;
+
+    IntervalModel *q = nullptr;
     OpeningHours oh;
-    std::vector<DayData> m_intervals;
     QDate beginDt = QDate::currentDate();
     QDate endDt = QDate::currentDate().addDays(7);
+
+    // julian day -> intervals on that day
+    QCache<qint64, std::vector<Interval>> m_dayCache;
+    // incremented on any change, to discard outdated prefetch results
+    int m_generation = 0;
+    int m_prefetchBegin = 0;
+    int m_prefetchEnd = 0;
+    std::shared_ptr<PrefetchGuard> m_prefetchGuard = std::make_shared<PrefetchGuard>();
 };
 }
 
+enum {
+    DayCacheSize = 3 * 366, // enough for a year view plus prefetched neighboring years
+    PrefetchDays = 42, // six weeks in either direction, enough for the neighboring pages of a month view
+};
+
+namespace {
+/** QRunnable::create() needs Qt 5.15. */
+template <typename F>
+class PrefetchJob : public QRunnable
+{
+public:
+    explicit PrefetchJob(F &&f) : m_f(std::move(f)) {}
+    void run() override { m_f(); }
+private:
+    F m_f;
+};
+
+template <typename F>
+PrefetchJob<F>* makePrefetchJob(F &&f)
+{
+    return new PrefetchJob<F>(std::forward<F>(f));
+}
+}
+
 static void clipIntervalEnd(Interval &i, const QDateTime &endDt)
 {
     i.setEnd(i.hasOpenEnd() ? endDt : std::min(i.end(), endDt));
@@ -41,59 +87,151 @@ static void clipIntervalEnd(Interval &i, const QDateTime &endDt)
     }
 }
 
+static std::vector<Interval> computeDay(const OpeningHours &oh, QDate day)
+{
+    const QDateTime beginDt(day, {0, 0});
+    const QDateTime endDt(day.addDays(1), {0, 0});
+    auto intervals = oh.intervals(beginDt, endDt);
+    // an invalid interval marks the end of all intervals
+    if (intervals.empty() || (!intervals.back().hasOpenEnd() && intervals.back().end() < endDt)) {
+        intervals.emplace_back();
+    }
+
+    // clip intervals to the current day, makes displaying much easier
+    auto &first = intervals.front();
+    first.setBegin(first.hasOpenBegin() ? beginDt : std::max(first.begin(), beginDt));
+    for (auto &i : intervals) {
+        clipIntervalEnd(i, endDt);
+    }
+
+    // fill open end time estimates
+    for (auto it = intervals.begin(); it != std::prev(intervals.end()); ++it) {
+        auto nextStartDt = endDt;
+        if (!(*it).hasOpenEndTime() || (*it).state() == Interval::Closed) {
+            continue;
+        }
+        for (auto nextIt = std::next(it); nextIt != intervals.end(); ++nextIt) {
+            if ((*nextIt).state() != Interval::Closed) {
+                nextStartDt = (*nextIt).begin();
+                break;
+            }
+        }
+
+        auto estimatedEnd = nextStartDt == endDt ? nextStartDt : (*it).end().addSecs((*it).end().secsTo(nextStartDt) / 2);
+        estimatedEnd = std::min(estimatedEnd, (*it).end().addSecs(4 * 3600));
+        (*it).setEstimatedEnd(estimatedEnd);
+        (*std::next(it)).setBegin(estimatedEnd);
+    }
+    return intervals;
+}
+
 void IntervalModelPrivate::repopulateModel()
 {
-    m_intervals.clear();
+    // computing happens lazily, see intervals()
+    ++m_generation;
+    m_dayCache.clear();
+    m_prefetchBegin = m_prefetchEnd = 0;
+}
+
+int IntervalModelPrivate::rowCount() const
+{
     if (endDt < beginDt || oh.error() != OpeningHours::NoError) {
+        return 0;
+    }
+    return beginDt.daysTo(endDt);
+}
+
+QDate IntervalModelPrivate::day(int row) const
+{
+    return beginDt.addDays(row);
+}
+
+const std::vector<Interval>& IntervalModelPrivate::intervals(int row)
+{
+    const auto jd = day(row).toJulianDay();
+    auto intervals = m_dayCache.object(jd);
+    if (!intervals) {
+        intervals = new std::vector<Interval>(computeDay(oh, day(row)));
+        m_dayCache.insert(jd, intervals);
+    }
+    prefetch(row);
+    return *intervals;
+}
+
+void IntervalModelPrivate::prefetch(int row)
+{
+    // only start prefetching when getting close to the edge of what we prefetched last time
+    if (row >= m_prefetchBegin + PrefetchDays / 2 && row < m_prefetchEnd - PrefetchDays / 2) {
         return;
     }
+    m_prefetchBegin = std::max(0, row - PrefetchDays);
+    m_prefetchEnd = std::min(rowCount(), row + PrefetchDays);
 
-    QDate dt = beginDt;
-    m_intervals.resize(beginDt.daysTo(endDt));
-    for (auto &dayData : m_intervals) {
-        dayData.day = dt;
-        auto i = oh.interval(QDateTime(dt, {0, 0}));
-
-        // clip intervals to the current day, makes displaying much easier
-        i.setBegin(i.hasOpenBegin() ? QDateTime(dt, {0, 0}) : std::max(i.begin(), QDateTime(dt, {0, 0})));
-        dt = dt.addDays(1);
-        clipIntervalEnd(i, QDateTime(dt, {0, 0}));
-
-        dayData.intervals.push_back(i);
-        while (i.isValid() && i.end() < QDateTime(dt, {0, 0})) {
-            i = oh.nextInterval(i);
-            clipIntervalEnd(i, QDateTime(dt, {0, 0}));
-            dayData.intervals.push_back(i);
+    std::vector<QDate> days;
+    for (int r = m_prefetchBegin; r < m_prefetchEnd; ++r) {
+        if (!m_dayCache.contains(day(r).toJulianDay())) {
+            days.push_back(day(r));
         }
+    }
+    if (days.empty()) {
+        return;
+    }
 
-        // fill open end time estimates
-        for (auto it = dayData.intervals.begin(); it != std::prev(dayData.intervals.end()); ++it) {
-            auto nextStartDt = QDateTime(dt, {0, 0});
-            if (!(*it).hasOpenEndTime() || (*it).state() == Interval::Closed) {
-                continue;
+    // d is only accessed from the queued call, which doesn't happen anymore once the model is gone
+    QThreadPool::globalInstance()->start(makePrefetchJob([d = this, guard = m_prefetchGuard, oh = privateCopy(), days = std::move(days), generation = m_generation]() {
+        auto result = std::make_shared<std::vector<std::vector<Interval>>>();
+        result->reserve(days.size());
+        for (const auto &day : days) {
+            result->push_back(computeDay(oh, day));
+        }
+        QMutexLocker lock(&guard->mutex);
+        if (!guard->model) {
+            return;
+        }
+        QMetaObject::invokeMethod(guard->model, [d, days, result, generation]() {
+            if (generation != d->m_generation) {
+                return;
             }
-            for (auto nextIt = std::next(it); nextIt != dayData.intervals.end(); ++nextIt) {
-                if ((*nextIt).state() != Interval::Closed) {
-                    nextStartDt = (*nextIt).begin();
-                    break;
+            int firstRow = d->rowCount(), lastRow = -1;
+            for (std::size_t i = 0; i < days.size(); ++i) {
+                const auto jd = days[i].toJulianDay();
+                if (d->m_dayCache.contains(jd)) {
+                    continue;
                 }
+                d->m_dayCache.insert(jd, new std::vector<Interval>(std::move((*result)[i])));
+                const auto row = static_cast<int>(d->beginDt.daysTo(days[i]));
+                firstRow = std::min(firstRow, row);
+                lastRow = std::max(lastRow, row);
+            }
+            if (firstRow <= lastRow) {
+                Q_EMIT d->q->dataChanged(d->q->index(firstRow, 0), d->q->index(lastRow, 0), {IntervalModel::IntervalsRole});
             }
+        }, Qt::QueuedConnection);
+    }));
+}
 
-            auto estimatedEnd = nextStartDt == QDateTime(dt, {0, 0}) ? nextStartDt : (*it).end().addSecs((*it).end().secsTo(nextStartDt) / 2);
-            estimatedEnd = std::min(estimatedEnd, (*it).end().addSecs(4 * 3600));
-            (*it).setEstimatedEnd(estimatedEnd);
-            (*std::next(it)).setBegin(estimatedEnd);
-        }
-    }
+OpeningHours IntervalModelPrivate::privateCopy() const
+{
+    // OpeningHours is explicitly shared, so the caller could still modify the instance we got
+    OpeningHours copy;
+    copy.d = QExplicitlySharedDataPointer<OpeningHoursPrivate>(oh.d->clone());
+    return copy;
 }
 
 IntervalModel::IntervalModel(QObject *parent)
     : QAbstractListModel(parent)
     , d(new IntervalModelPrivate)
 {
+    d->q = this;
+    d->m_dayCache.setMaxCost(DayCacheSize);
+    d->m_prefetchGuard->model = this;
 }
 
-IntervalModel::~IntervalModel() = default;
+IntervalModel::~IntervalModel()
+{
+    QMutexLocker lock(&d->m_prefetchGuard->mutex);
+    d->m_prefetchGuard->model = nullptr;
+}
 
 OpeningHours IntervalModel::openingHours() const
 {
@@ -154,7 +292,7 @@ int IntervalModel::rowCount(const QModelIndex &parent) const
     if (parent.isValid()) {
         return 0;
     }
-    return d->m_intervals.size();
+    return d->rowCount();
 }
 
 QVariant IntervalModel::data(const QModelIndex &index, int role) const
@@ -163,19 +301,20 @@ QVariant IntervalModel::data(const QModelIndex &index, int role) const
         return {};
     }
 
+    const auto day = d->day(index.row());
     switch (role) {
         case Qt::DisplayRole:
-            return QLocale().toString(d->m_intervals[index.row()].day, QLocale::ShortFormat);
+            return QLocale().toString(day, QLocale::ShortFormat);
         case IntervalsRole:
-            return QVariant::fromValue(d->m_intervals[index.row()].intervals);
+            return QVariant::fromValue(d->intervals(index.row()));
         case DateRole:
-            return d->m_intervals[index.row()].day;
+            return day;
         case DayBeginTimeRole:
-            return QDateTime(d->m_intervals[index.row()].day, {0, 0});
+            return QDateTime(day, {0, 0});
         case ShortDayNameRole:
-             return QLocale().standaloneDayName(d->m_intervals[index.row()].day.dayOfWeek(), QLocale::ShortFormat);
+             return QLocale().standaloneDayName(day.dayOfWeek(), QLocale::ShortFormat);
         case IsTodayRole:
-            return d->m_intervals[index.row()].day == QDate::currentDate();
+            return day == QDate::currentDate();
     }
 
     return {};
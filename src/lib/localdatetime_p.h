@@ -0,0 +1,87 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_LOCALDATETIME_P_H
+#define KOPENINGHOURS_LOCALDATETIME_P_H
+
+#include <QDate>
+#include <QDateTime>
+#include <QTime>
+
+#include <limits>
+
+namespace KOpeningHours {
+
+/** Local date and time as used during evaluation.
+ *  This is the wall clock time in seconds since the begin of Julian day 0, which avoids
+ *  the cost of QDateTime's time zone and DST handling inside the evaluator. Conversion
+ *  from and to QDateTime only happens when entering and leaving evaluation.
+ *
+ *  Like QDateTime, invalid values compare less than any valid value and are preserved
+ *  by arithmetic operations.
+ */
+class LocalDateTime
+{
+public:
+    constexpr inline LocalDateTime() = default;
+    inline explicit LocalDateTime(QDate date, int secsOfDay = 0)
+        : m_secs(date.isValid() ? date.toJulianDay() * SecsPerDay + secsOfDay : Invalid)
+    {}
+    inline LocalDateTime(QDate date, int hour, int minute)
+        : LocalDateTime(date, hour * 3600 + minute * 60)
+    {}
+
+    /** Wall clock time of @p dt, in whatever time spec it is in. */
+    static inline LocalDateTime fromDateTime(const QDateTime &dt)
+    {
+        return dt.isValid() ? LocalDateTime(dt.date(), dt.time().msecsSinceStartOfDay() / 1000) : LocalDateTime();
+    }
+    /** Wall clock time @p secs seconds after 1970-01-01 00:00. */
+    static inline LocalDateTime fromSecsSinceEpoch(qint64 secs)
+    {
+        return fromSecs(EpochJulianDay * SecsPerDay + secs);
+    }
+    /** Corresponding local time QDateTime. */
+    inline QDateTime toDateTime() const
+    {
+        return isValid() ? QDateTime(date(), QTime::fromMSecsSinceStartOfDay(secsOfDay() * 1000)) : QDateTime();
+    }
+
+    inline bool isValid() const { return m_secs != Invalid; }
+    inline QDate date() const { return QDate::fromJulianDay(m_secs / SecsPerDay); }
+    inline int secsOfDay() const { return static_cast<int>(m_secs % SecsPerDay); }
+    inline int dayOfWeek() const { return static_cast<int>((m_secs / SecsPerDay) % 7) + 1; }
+
+    inline LocalDateTime addSecs(qint64 secs) const { return isValid() ? fromSecs(m_secs + secs) : LocalDateTime(); }
+    inline LocalDateTime addDays(qint64 days) const { return addSecs(days * SecsPerDay); }
+    /** Seconds from this to @p other, 0 if either is invalid. */
+    inline qint64 secsTo(LocalDateTime other) const { return isValid() && other.isValid() ? other.m_secs - m_secs : 0; }
+
+    inline bool operator==(LocalDateTime other) const { return m_secs == other.m_secs; }
+    inline bool operator!=(LocalDateTime other) const { return m_secs != other.m_secs; }
+    inline bool operator<(LocalDateTime other) const { return m_secs < other.m_secs; }
+    inline bool operator<=(LocalDateTime other) const { return m_secs <= other.m_secs; }
+    inline bool operator>(LocalDateTime other) const { return m_secs > other.m_secs; }
+    inline bool operator>=(LocalDateTime other) const { return m_secs >= other.m_secs; }
+
+private:
+    static constexpr qint64 SecsPerDay = 24 * 3600;
+    static constexpr qint64 Invalid = std::numeric_limits<qint64>::min();
+    static constexpr qint64 EpochJulianDay = 2440588; // 1970-01-01
+
+    static inline LocalDateTime fromSecs(qint64 secs)
+    {
+        LocalDateTime dt;
+        dt.m_secs = secs;
+        return dt;
+    }
+
+    qint64 m_secs = Invalid;
+};
+
+}
+
+#endif // KOPENINGHOURS_LOCALDATETIME_P_H
@@ -0,0 +1,93 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_LOCALINTERVAL_P_H
+#define KOPENINGHOURS_LOCALINTERVAL_P_H
+
+#include "interval.h"
+#include "localdatetime_p.h"
+#include "stringpool_p.h"
+
+#include <vector>
+
+namespace KOpeningHours {
+
+/** Interval representation used during evaluation.
+ *  Same semantics as Interval, but as a plain value type without heap allocations,
+ *  using LocalDateTime for begin and end and an integer id for the comment. Conversion to Interval only happens
+ *  for the final evaluation result.
+ */
+class LocalInterval
+{
+public:
+    inline bool isValid() const { return state != Interval::Invalid; }
+    inline bool hasOpenBegin() const { return !begin.isValid(); }
+    inline bool hasOpenEnd() const { return !end.isValid(); }
+
+    inline bool operator<(const LocalInterval &other) const
+    {
+        if (hasOpenBegin() && !other.hasOpenBegin()) {
+            return true;
+        }
+        if (other.hasOpenBegin() && !hasOpenBegin()) {
+            return false;
+        }
+
+        if (begin == other.begin) {
+            return end < other.end;
+        }
+        return begin < other.begin;
+    }
+
+    inline bool intersects(const LocalInterval &other) const
+    {
+        if (end.isValid() && other.begin.isValid() && end <= other.begin) {
+            return false;
+        }
+        if (other.end.isValid() && begin.isValid() && other.end <= begin) {
+            return false;
+        }
+        return true;
+    }
+
+    inline bool contains(LocalDateTime dt) const
+    {
+        if (openEndTime && begin.isValid() && begin == end) {
+            return dt == begin;
+        }
+        return (begin.isValid() ? begin <= dt : true) && (end.isValid() ? dt < end : true);
+    }
+
+    /** Marks comment ids referring to holiday names in the StringPool. */
+    enum : quint32 { HolidayNameFlag = 1u << 31 };
+
+    /** Converts to an Interval, resolving the comment in @p comments if necessary. */
+    inline Interval toInterval(const std::vector<QString> &comments) const
+    {
+        Interval i;
+        i.setBegin(begin.toDateTime());
+        i.setEnd(end.toDateTime());
+        i.setState(state);
+        i.setOpenEndTime(openEndTime);
+        if (comment & HolidayNameFlag) {
+            i.setComment(StringPool::string(comment & ~HolidayNameFlag));
+        } else if (comment) {
+            i.setComment(comments[comment]);
+        }
+        return i;
+    }
+
+    LocalDateTime begin;
+    LocalDateTime end;
+    // index into OpeningHoursPrivate::m_comments, or a StringPool id with HolidayNameFlag set, 0 for no comment
+    quint32 comment = 0;
+    Interval::State state = Interval::Invalid;
+    bool openEndTime = false;
+};
+
+}
+
+#endif // KOPENINGHOURS_LOCALINTERVAL_P_H
@@ -6,19 +6,28 @@
 
 #include "openinghours.h"
 #include "openinghours_p.h"
+#include "fastparser_p.h"
 #include "openinghoursparser_p.h"
 #include "openinghoursscanner_p.h"
 #include "holidaycache_p.h"
 #include "interval.h"
 #include "rule_p.h"
+#include "statistics_p.h"
+#include "threadpool_p.h"
 #include "logging.h"
 
 #include <QDateTime>
 #include <QJsonArray>
 #include <QJsonObject>
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+#include <QtConcurrentRun>
+#endif
 #include <QTimeZone>
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <utility>
 
 using namespace KOpeningHours;
 
@@ -48,11 +57,14 @@ void OpeningHoursPrivate::autocorrect()
     // this matters as those two variants have widely varying semantics, and often occur technically wrong in the wild
     // the other case is "Mo-Fr 06:30-12:00, 13:00-18:00", which should become "Mo-Fr 06:30-12:00,13:00-18:00"
 
-    for (auto it = std::next(m_rules.begin()); it != m_rules.end(); ++it) {
-        auto rule = (*it).get();
-        auto prevRule = (*(std::prev(it))).get();
+    // merged rules are removed by compacting m_rules in place, rather than erasing them one at a time
+    std::size_t last = 0; // the last rule kept so far, which the current one might be merged into
+    for (std::size_t i = 1; i < m_rules.size(); ++i) {
+        auto rule = m_rules[i];
+        auto prevRule = m_rules[last];
 
         if (rule->hasComment() || prevRule->hasComment() || !prevRule->hasImplicitState()) {
+            m_rules[++last] = rule;
             continue;
         }
         const auto prevRuleSingleSelector = prevRule->selectorCount() == 1;
@@ -62,51 +74,51 @@ void OpeningHoursPrivate::autocorrect()
             // the previous rule has no time selector, the current rule only has a weekday selector.
             // so we fold the two rules together
             if (!prevRule->m_timeSelector && prevRule->m_weekdaySelector && rule->m_weekdaySelector && !rule->hasWideRangeSelector()) {
-                auto tmp = std::move(rule->m_weekdaySelector);
-                rule->m_weekdaySelector = std::move(prevRule->m_weekdaySelector);
-                rule->m_weekSelector = std::move(prevRule->m_weekSelector);
-                rule->m_monthdaySelector = std::move(prevRule->m_monthdaySelector);
-                rule->m_yearSelector = std::move(prevRule->m_yearSelector);
+                auto tmp = std::exchange(rule->m_weekdaySelector, nullptr);
+                rule->m_weekdaySelector = std::exchange(prevRule->m_weekdaySelector, nullptr);
+                rule->m_weekSelector = std::exchange(prevRule->m_weekSelector, nullptr);
+                rule->m_monthdaySelector = std::exchange(prevRule->m_monthdaySelector, nullptr);
+                rule->m_yearSelector = std::exchange(prevRule->m_yearSelector, nullptr);
                 rule->m_colonAfterWideRangeSelector = prevRule->m_colonAfterWideRangeSelector;
-                auto *selector = rule->m_weekdaySelector.get();
+                auto *selector = rule->m_weekdaySelector;
                 while (selector->rhsAndSelector)
-                    selector = selector->rhsAndSelector.get();
-                appendSelector(selector, std::move(tmp));
+                    selector = selector->rhsAndSelector;
+                appendSelector(selector, tmp);
                 rule->m_ruleType = prevRule->m_ruleType;
-                std::swap(*it, *std::prev(it));
-                it = std::prev(m_rules.erase(it));
+                m_rules[last] = rule;
+                continue;
             }
 
             // the current rule only has a time selector, so we append that to the previous rule
-            else if (curRuleSingleSelector && rule->m_timeSelector && prevRule->m_timeSelector) {
-                appendSelector(prevRule->m_timeSelector.get(), std::move(rule->m_timeSelector));
+            if (curRuleSingleSelector && rule->m_timeSelector && prevRule->m_timeSelector) {
+                appendSelector(prevRule->m_timeSelector, std::exchange(rule->m_timeSelector, nullptr));
                 prevRule->copyStateFrom(*rule);
-                it = std::prev(m_rules.erase(it));
+                continue;
             }
 
             // previous is a single weekday selector and current is a single time selector
-            else if (curRuleSingleSelector && prevRuleSingleSelector && rule->m_timeSelector && prevRule->m_weekdaySelector) {
-                prevRule->m_timeSelector = std::move(rule->m_timeSelector);
-                it = std::prev(m_rules.erase(it));
+            if (curRuleSingleSelector && prevRuleSingleSelector && rule->m_timeSelector && prevRule->m_weekdaySelector) {
+                prevRule->m_timeSelector = std::exchange(rule->m_timeSelector, nullptr);
+                continue;
             }
 
             // previous is a single monthday selector
-            else if (rule->m_monthdaySelector && prevRuleSingleSelector && prevRule->m_monthdaySelector && !isWiderThan(prevRule, rule)) {
-                auto tmp = std::move(rule->m_monthdaySelector);
-                rule->m_monthdaySelector = std::move(prevRule->m_monthdaySelector);
-                appendSelector(rule->m_monthdaySelector.get(), std::move(tmp));
+            if (rule->m_monthdaySelector && prevRuleSingleSelector && prevRule->m_monthdaySelector && !isWiderThan(prevRule, rule)) {
+                auto tmp = std::exchange(rule->m_monthdaySelector, nullptr);
+                rule->m_monthdaySelector = std::exchange(prevRule->m_monthdaySelector, nullptr);
+                appendSelector(rule->m_monthdaySelector, tmp);
                 rule->m_ruleType = prevRule->m_ruleType;
-                std::swap(*it, *std::prev(it));
-                it = std::prev(m_rules.erase(it));
+                m_rules[last] = rule;
+                continue;
             }
 
             // previous has no time selector and the current one is a misplaced 24/7 rule:
             // convert the 24/7 to a 00:00-24:00 time selector
-            else if (rule->selectorCount() == 0 && rule->m_seen_24_7 && !prevRule->m_timeSelector) {
-                prevRule->m_timeSelector.reset(new Timespan);
+            if (rule->selectorCount() == 0 && rule->m_seen_24_7 && !prevRule->m_timeSelector) {
+                prevRule->m_timeSelector = m_arena->create<Timespan>();
                 prevRule->m_timeSelector->begin = { Time::NoEvent, 0, 0 };
                 prevRule->m_timeSelector->end = { Time::NoEvent, 24, 0 };
-                it = std::prev(m_rules.erase(it));
+                continue;
             }
         } else if (rule->m_ruleType == Rule::NormalRule) {
             // Previous rule has time and other selectors
@@ -115,27 +127,29 @@ void OpeningHoursPrivate::autocorrect()
             if (curRuleSingleSelector && rule->m_timeSelector
                     && prevRule->selectorCount() > 1 && prevRule->m_timeSelector
                     && rule->state() == prevRule->state()) {
-                appendSelector(prevRule->m_timeSelector.get(), std::move(rule->m_timeSelector));
-                it = std::prev(m_rules.erase(it));
+                appendSelector(prevRule->m_timeSelector, std::exchange(rule->m_timeSelector, nullptr));
+                continue;
             }
 
             // Both rules have exactly the same selector apart from time
             // Ex: "Mo-Sa 12:00-15:00; Mo-Sa 18:00-24:00" => "Mo-Sa 12:00-15:00,18:00-24:00"
             // Obviously a bug, it was overwriting the 12:00-15:00 range.
             // For now this only supports weekday selectors, could be extended
-            else if (rule->selectorCount() == prevRule->selectorCount()
+            if (rule->selectorCount() == prevRule->selectorCount()
                      && rule->m_timeSelector && prevRule->m_timeSelector
                      && !rule->hasComment() && !prevRule->hasComment()
                      && rule->selectorCount() == 2 && rule->m_weekdaySelector && prevRule->m_weekdaySelector
-                     // slower than writing an operator==, but so much easier to write :)
-                     && rule->m_weekdaySelector->toExpression() == prevRule->m_weekdaySelector->toExpression()
+                     && *rule->m_weekdaySelector == *prevRule->m_weekdaySelector
                      && rule->state() == prevRule->state()
                      ) {
-                appendSelector(prevRule->m_timeSelector.get(), std::move(rule->m_timeSelector));
-                it = std::prev(m_rules.erase(it));
+                appendSelector(prevRule->m_timeSelector, std::exchange(rule->m_timeSelector, nullptr));
+                continue;
             }
         }
+
+        m_rules[++last] = rule;
     }
+    m_rules.resize(last + 1);
 }
 
 void OpeningHoursPrivate::simplify()
@@ -144,28 +158,30 @@ void OpeningHoursPrivate::simplify()
         return;
     }
 
-    for (auto it = std::next(m_rules.begin()); it != m_rules.end(); ++it) {
-        auto rule = (*it).get();
-        auto prevRule = (*(std::prev(it))).get();
+    // merges only happen between neighbors, as the order of rules matters for their meaning
+    // merged rules are removed by compacting m_rules in place
+    const auto hasNoHoliday = [](WeekdayRange *selector) {
+        return selector->holiday == WeekdayRange::NoHoliday
+                && !selector->lhsAndSelector;
+    };
 
-        if (rule->m_ruleType == Rule::AdditionalRule || rule->m_ruleType == Rule::NormalRule) {
+    std::size_t last = 0; // the last rule kept so far, which the current one might be merged into
+    for (std::size_t i = 1; i < m_rules.size(); ++i) {
+        auto rule = m_rules[i];
+        auto prevRule = m_rules[last];
 
-            auto hasNoHoliday = [](WeekdayRange *selector) {
-                return selector->holiday == WeekdayRange::NoHoliday
-                        && !selector->lhsAndSelector;
-            };
+        if (rule->m_ruleType == Rule::AdditionalRule || rule->m_ruleType == Rule::NormalRule) {
             // Both rules have the same time and a different weekday selector
             // Mo 08:00-13:00; Tu 08:00-13:00 => Mo,Tu 08:00-13:00
             if (rule->selectorCount() == prevRule->selectorCount()
                     && rule->m_timeSelector && prevRule->m_timeSelector
                     && rule->selectorCount() == 2 && rule->m_weekdaySelector && prevRule->m_weekdaySelector
-                    && hasNoHoliday(rule->m_weekdaySelector.get())
-                    && hasNoHoliday(prevRule->m_weekdaySelector.get())
+                    && hasNoHoliday(rule->m_weekdaySelector)
+                    && hasNoHoliday(prevRule->m_weekdaySelector)
                     && *rule->m_timeSelector == *prevRule->m_timeSelector
                     ) {
                 // We could of course also turn Mo,Tu,We,Th into Mo-Th...
-                appendSelector(prevRule->m_weekdaySelector.get(), std::move(rule->m_weekdaySelector));
-                it = std::prev(m_rules.erase(it));
+                appendSelector(prevRule->m_weekdaySelector, std::exchange(rule->m_weekdaySelector, nullptr));
                 continue;
             }
         }
@@ -178,20 +194,22 @@ void OpeningHoursPrivate::simplify()
                     && rule->m_timeSelector && prevRule->m_timeSelector
                     && !rule->hasComment() && !prevRule->hasComment()
                     && rule->selectorCount() == 2 && rule->m_weekdaySelector && prevRule->m_weekdaySelector
-                    // slower than writing an operator==, but so much easier to write :)
-                    && rule->m_weekdaySelector->toExpression() == prevRule->m_weekdaySelector->toExpression()
+                    && *rule->m_weekdaySelector == *prevRule->m_weekdaySelector
                     ) {
-                appendSelector(prevRule->m_timeSelector.get(), std::move(rule->m_timeSelector));
-                it = std::prev(m_rules.erase(it));
+                appendSelector(prevRule->m_timeSelector, std::exchange(rule->m_timeSelector, nullptr));
+                continue;
             }
         }
+
+        m_rules[++last] = rule;
     }
+    m_rules.resize(last + 1);
 
     // Now try collapsing adjacent week days: Mo,Tu,We => Mo-We
     for (auto it = m_rules.begin(); it != m_rules.end(); ++it) {
-        auto rule = (*it).get();
+        auto rule = *it;
         if (rule->m_weekdaySelector) {
-            rule->m_weekdaySelector->simplify();
+            rule->m_weekdaySelector->simplify(*m_arena);
         }
         if (rule->m_monthdaySelector) {
             rule->m_monthdaySelector->simplify();
@@ -201,6 +219,13 @@ void OpeningHoursPrivate::simplify()
 
 void OpeningHoursPrivate::validate()
 {
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+    m_weeklySchedule = {};
+    m_ruleEndDates.clear();
+    m_timeline.reset();
+    m_sunEvents.clear();
+    m_timezoneTable.reset();
+#endif
     if (m_error == OpeningHours::SyntaxError) {
         return;
     }
@@ -235,12 +260,34 @@ void OpeningHoursPrivate::validate()
     }
 
     m_error = OpeningHours::NoError;
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+    m_weeklySchedule = WeeklySchedule::compile(m_rules);
+    m_ruleEndDates.reserve(m_rules.size());
+    for (const auto &rule : m_rules) {
+        m_ruleEndDates.push_back(rule->endDate());
+    }
+#endif
 }
 
-void OpeningHoursPrivate::addRule(Rule *parsedRule)
+void OpeningHoursPrivate::assignCommentIds()
 {
-    std::unique_ptr<Rule> rule(parsedRule);
+    // the rules are only shared with other instances once we are done here, so changing them is safe
+    m_comments.resize(1);
+    for (const auto rule : m_rules) {
+        if (rule->m_comment.isEmpty()) {
+            rule->m_commentId = 0;
+            continue;
+        }
+        const auto it = std::find(m_comments.begin() + 1, m_comments.end(), rule->m_comment);
+        rule->m_commentId = static_cast<quint32>(std::distance(m_comments.begin(), it));
+        if (it == m_comments.end()) {
+            m_comments.push_back(rule->m_comment);
+        }
+    }
+}
 
+void OpeningHoursPrivate::addRule(Rule *rule)
+{
     // discard empty rules
     if (rule->isEmpty()) {
         return;
@@ -257,8 +304,7 @@ void OpeningHoursPrivate::addRule(Rule *parsedRule)
         if (rule->selectorCount() <= 1) {
             // missing separator was actually between time selectors, not rules
             if (m_rules.back()->m_timeSelector && rule->m_timeSelector && m_rules.back()->state() == rule->state()) {
-                appendSelector(m_rules.back()->m_timeSelector.get(), std::move(rule->m_timeSelector));
-                rule.reset();
+                appendSelector(m_rules.back()->m_timeSelector, std::exchange(rule->m_timeSelector, nullptr));
                 return;
             } else {
                 m_error = OpeningHours::SyntaxError;
@@ -270,7 +316,7 @@ void OpeningHoursPrivate::addRule(Rule *parsedRule)
         // part is "wider" than the right-hand side.
         if (m_rules.back()->hasWideRangeSelector() && rule->hasWideRangeSelector()
             && !m_rules.back()->hasSmallRangeSelector() && rule->hasSmallRangeSelector()
-            && isWiderThan(rule.get(), m_rules.back().get()))
+            && isWiderThan(rule, m_rules.back()))
         {
             m_error = OpeningHours::SyntaxError;
         }
@@ -285,7 +331,7 @@ void OpeningHoursPrivate::addRule(Rule *parsedRule)
     }
 
     m_ruleSeparatorRecovery = false;
-    m_rules.push_back(std::move(rule));
+    m_rules.push_back(rule);
 }
 
 void OpeningHoursPrivate::restartFrom(int pos, Rule::Type nextRuleType)
@@ -310,6 +356,26 @@ bool OpeningHoursPrivate::isRecovering() const
     return m_restartPosition > 0;
 }
 
+OpeningHoursPrivate* OpeningHoursPrivate::clone() const
+{
+    auto d = new OpeningHoursPrivate;
+    d->m_arena = m_arena;
+    d->m_rules = m_rules;
+    d->m_comments = m_comments;
+    d->m_modes = m_modes;
+    d->m_error = m_error.load();
+    d->m_parseStatistics = m_parseStatistics;
+    d->m_latitude = m_latitude;
+    d->m_longitude = m_longitude;
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+    d->m_region = m_region;
+    d->m_weeklySchedule = m_weeklySchedule;
+    d->m_ruleEndDates = m_ruleEndDates;
+#endif
+    d->m_timezone = m_timezone;
+    return d;
+}
+
 
 OpeningHours::OpeningHours()
     : d(new OpeningHoursPrivate)
@@ -337,67 +403,137 @@ OpeningHours::~OpeningHours() = default;
 OpeningHours& OpeningHours::operator=(const OpeningHours&) = default;
 OpeningHours& OpeningHours::operator=(OpeningHours&&) = default;
 
-void OpeningHours::setExpression(const QByteArray &openingHours, OpeningHours::Modes modes)
+namespace {
+/** Scanner state and input buffer, reused for all expressions parsed on the same thread. */
+class ScannerContext
 {
-    setExpression(openingHours.constData(), openingHours.size(), modes);
-}
+public:
+    ~ScannerContext()
+    {
+        if (scanner) {
+            yylex_destroy(scanner);
+        }
+    }
 
-void OpeningHours::setExpression(const char *openingHours, std::size_t size, Modes modes)
-{
-    d->m_modes = modes;
+    yyscan_t scanner = nullptr;
+    QByteArray buffer;
+};
+}
 
-    d->m_error = OpeningHours::Null;
-    d->m_rules.clear();
-    d->m_initialRuleType = Rule::NormalRule;
-    d->m_recoveryRuleType = Rule::NormalRule;
-    d->m_ruleSeparatorRecovery = false;
+static thread_local ScannerContext t_scannerContext;
 
-    // trim trailing spaces
-    // the parser would handle most of this by itself, but fails if a trailing space would produce a trailing rule separator.
-    // so it's easier to just clean this here.
-    while (size > 0 && std::isspace(static_cast<unsigned char>(openingHours[size - 1]))) {
-        --size;
-    }
-    if (size == 0) {
-        return;
+/** Runs the full scanner and parser on @p openingHours, including error recovery. */
+static bool parseExpression(OpeningHoursPrivate *d, const char *openingHours, std::size_t size, OpeningHours::ParseStatistics &stats)
+{
+    auto &context = t_scannerContext;
+    if (!context.scanner && yylex_init(&context.scanner)) {
+        qCWarning(Log) << "Failed to initialize scanner?!";
+        context.scanner = nullptr;
+        d->m_error = OpeningHours::SyntaxError;
+        return false;
     }
 
     d->m_restartPosition = 0;
     int offset = 0;
     do {
-        yyscan_t scanner;
-        if (yylex_init(&scanner)) {
-            qCWarning(Log) << "Failed to initialize scanner?!";
-            d->m_error = SyntaxError;
-            return;
-        }
-        const std::unique_ptr<void, decltype(&yylex_destroy)> lexerCleanup(scanner, &yylex_destroy);
-
-        YY_BUFFER_STATE state;
-        state = yy_scan_bytes(openingHours + offset, size - offset, scanner);
-        if (yyparse(d.data(), scanner)) {
+        // the scanner works in-place on a buffer terminated by two null bytes and modifies that while
+        // scanning, so this needs to be refilled for every restart, but that doesn't need to allocate memory
+        context.buffer.resize(size - offset + 2);
+        const auto buffer = context.buffer.data();
+        std::memcpy(buffer, openingHours + offset, size - offset);
+        buffer[size - offset] = buffer[size - offset + 1] = '\0';
+
+        const auto state = yy_scan_buffer(buffer, context.buffer.size(), context.scanner);
+        const auto parseResult = yyparse(d, context.scanner);
+        yy_delete_buffer(state, context.scanner);
+        if (parseResult) {
             if (d->m_restartPosition > 1 && d->m_restartPosition + offset < (int)size) {
+                ++stats.restartCount;
+                StatisticsCollector::increment(StatisticsCollector::ParserRestartCount);
                 offset += d->m_restartPosition - 1;
                 d->m_initialRuleType = d->m_recoveryRuleType;
                 d->m_recoveryRuleType = Rule::NormalRule;
                 d->m_restartPosition = 0;
             } else {
-                d->m_error = SyntaxError;
-                return;
+                d->m_error = OpeningHours::SyntaxError;
+                return false;
             }
-            d->m_error = NoError;
+            d->m_error = OpeningHours::NoError;
         } else {
-            if (d->m_error != SyntaxError) {
-                d->m_error = NoError;
+            if (d->m_error != OpeningHours::SyntaxError) {
+                d->m_error = OpeningHours::NoError;
             }
             offset = -1;
         }
-
-        yy_delete_buffer(state, scanner);
     } while (offset > 0);
+    return true;
+}
+
+// trim trailing spaces
+// the parser would handle most of this by itself, but fails if a trailing space would produce a trailing rule separator.
+// so it's easier to just clean this here.
+static std::size_t trimmedSize(const char *openingHours, std::size_t size)
+{
+    while (size > 0 && std::isspace(static_cast<unsigned char>(openingHours[size - 1]))) {
+        --size;
+    }
+    return size;
+}
+
+/** Appends the rules of @p openingHours to @p d, without autocorrection or validation. */
+static bool parseRules(OpeningHoursPrivate *d, const char *openingHours, std::size_t size, OpeningHours::ParseStatistics &stats)
+{
+    d->m_initialRuleType = Rule::NormalRule;
+    d->m_recoveryRuleType = Rule::NormalRule;
+    d->m_ruleSeparatorRecovery = false;
 
+    // most expressions in real data are trivial canonical ones, which don't need the full parser
+    return FastParser::parse(d, openingHours, size) || parseExpression(d, openingHours, size, stats);
+}
+
+void OpeningHours::setExpression(const QByteArray &openingHours, OpeningHours::Modes modes)
+{
+    setExpression(openingHours.constData(), openingHours.size(), modes);
+}
+
+void OpeningHours::setExpression(const char *openingHours, std::size_t size, Modes modes)
+{
+    const StatisticsCollector::ElapsedTimer timer;
+
+    detach();
+    auto &stats = d->m_parseStatistics;
+    stats = {};
+    d->m_modes = modes;
+
+    d->m_error = OpeningHours::Null;
+    d->m_rules.clear();
+    if (d->m_arena.use_count() > 1) {
+        d->m_arena = std::make_shared<AstArena>();
+    } else {
+        d->m_arena->clear();
+    }
+
+    size = trimmedSize(openingHours, size);
+    if (size == 0) {
+        return;
+    }
+
+    if (!parseRules(d.data(), openingHours, size, stats)) {
+        stats.parseTime = timer.nsecsElapsed();
+        return;
+    }
+    stats.parseTime = timer.nsecsElapsed();
+
+    d->assignCommentIds();
     d->autocorrect();
+    stats.autocorrectTime = timer.nsecsElapsed() - stats.parseTime;
     d->validate();
+    stats.validateTime = timer.nsecsElapsed() - stats.parseTime - stats.autocorrectTime;
+}
+
+OpeningHours::ParseStatistics OpeningHours::parseStatistics() const
+{
+    return d->m_parseStatistics;
 }
 
 QByteArray OpeningHours::normalizedExpression() const
@@ -443,6 +579,7 @@ QString OpeningHours::normalizedExpressionString() const
 
 void OpeningHours::setLocation(float latitude, float longitude)
 {
+    detach();
     d->m_latitude = latitude;
     d->m_longitude = longitude;
     d->validate();
@@ -455,6 +592,7 @@ float OpeningHours::latitude() const
 
 void OpeningHours::setLatitude(float latitude)
 {
+    detach();
     d->m_latitude = latitude;
     d->validate();
 }
@@ -466,6 +604,7 @@ float OpeningHours::longitude() const
 
 void OpeningHours::setLongitude(float longitude)
 {
+    detach();
     d->m_longitude = longitude;
     d->validate();
 }
@@ -478,6 +617,7 @@ QString OpeningHours::region() const
 
 void OpeningHours::setRegion(QStringView region)
 {
+    detach();
     d->m_region = HolidayCache::resolveRegion(region);
     d->validate();
 }
@@ -490,7 +630,13 @@ QTimeZone OpeningHours::timeZone() const
 
 void OpeningHours::setTimeZone(const QTimeZone &tz)
 {
+    detach();
     d->m_timezone = tz;
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+    d->m_timeline.reset();
+    d->m_sunEvents.clear();
+    d->m_timezoneTable.reset();
+#endif
 }
 
 QString OpeningHours::timeZoneId() const
@@ -500,7 +646,7 @@ QString OpeningHours::timeZoneId() const
 
 void OpeningHours::setTimeZoneId(const QString &tzId)
 {
-    d->m_timezone = QTimeZone(tzId.toUtf8());
+    setTimeZone(QTimeZone(tzId.toUtf8()));
 }
 
 OpeningHours::Error OpeningHours::error() const
@@ -508,34 +654,66 @@ OpeningHours::Error OpeningHours::error() const
     return d->m_error;
 }
 
+void OpeningHours::detach()
+{
+    if (d->m_cached) {
+        d = QExplicitlySharedDataPointer<OpeningHoursPrivate>(d->clone());
+    }
+}
+
 #ifndef KOPENINGHOURS_VALIDATOR_ONLY
-Interval OpeningHours::interval(const QDateTime &dt) const
+// days after Rule::endDate() during which a rule can still produce results
+enum { RuleEndDateMargin = 2 };
+
+RuleResult OpeningHoursPrivate::evaluateRule(std::size_t ruleIndex, LocalDateTime dt, std::vector<RuleCursor> *cursors)
 {
-    if (d->m_error != NoError) {
-        return {};
+    // skip rules that cannot match anymore, such as exceptions for past years
+    // the margin accounts for time selectors extending into the following days
+    const auto endDate = ruleIndex < m_ruleEndDates.size() ? m_ruleEndDates[ruleIndex] : QDate();
+    if (endDate.isValid() && endDate.daysTo(dt.date()) > RuleEndDateMargin) {
+        return {{}, RuleResult::Merge};
+    }
+
+    if (!cursors) {
+        return m_rules[ruleIndex]->nextInterval(dt, this);
+    }
+    auto &cursor = (*cursors)[ruleIndex];
+    if (cursor.covers(dt)) {
+        return cursor.resultAt(dt);
+    }
+    cursor.queryTime = dt;
+    cursor.result = m_rules[ruleIndex]->nextInterval(dt, this);
+    return cursor.result;
+}
+
+Interval OpeningHoursPrivate::evaluateInterval(const QDateTime &dt, std::vector<RuleCursor> *cursors)
+{
+    if (m_weeklySchedule.isValid()) {
+        return m_weeklySchedule.interval(dt);
     }
 
-    const auto alignedTime = QDateTime(dt.date(), {dt.time().hour(), dt.time().minute()});
-    Interval i;
+    const auto alignedTime = LocalDateTime(dt.date(), dt.time().hour(), dt.time().minute());
+    const auto localTime = LocalDateTime::fromDateTime(dt.toLocalTime());
+    LocalInterval i;
     // first try to find the nearest open interval, and afterwards check closed rules
-    for (const auto &rule : d->m_rules) {
+    for (std::size_t ruleIndex = 0; ruleIndex < m_rules.size(); ++ruleIndex) {
+        const auto rule = m_rules[ruleIndex];
         if (rule->state() == Interval::Closed) {
             continue;
         }
-        if (i.isValid() && i.contains(dt) && rule->m_ruleType == Rule::FallbackRule) {
+        if (i.isValid() && i.contains(localTime) && rule->m_ruleType == Rule::FallbackRule) {
             continue;
         }
-        auto res = rule->nextInterval(alignedTime, d.data());
+        auto res = evaluateRule(ruleIndex, alignedTime, cursors);
         if (!res.interval.isValid()) {
             continue;
         }
         if (i.isValid() && res.mode == RuleResult::Override) {
-            if (res.interval.begin().isValid() && res.interval.begin().date() > alignedTime.date()) {
-                i = Interval();
-                i.setBegin(alignedTime);
-                i.setEnd({alignedTime.date().addDays(1), {0, 0}});
-                i.setState(Interval::Closed),
-                i.setComment({});
+            if (res.interval.begin.isValid() && res.interval.begin.date() > alignedTime.date()) {
+                i = LocalInterval();
+                i.begin = alignedTime;
+                i.end = LocalDateTime(alignedTime.date().addDays(1));
+                i.state = Interval::Closed;
             } else {
                 i = res.interval;
             }
@@ -545,20 +723,20 @@ Interval OpeningHours::interval(const QDateTime &dt) const
             } else {
                 // fallback rule interval needs to be capped to the next occurrence of one of its preceding rules
                 if (rule->m_ruleType == Rule::FallbackRule) {
-                    res.interval.setEnd(res.interval.hasOpenEnd() ? i.begin() : std::min(res.interval.end(), i.begin()));
+                    res.interval.end = res.interval.hasOpenEnd() ? i.begin : std::min(res.interval.end, i.begin);
                 }
-                i = i.isValid() ? std::min(i, res.interval) : res.interval;
+                i = std::min(i, res.interval);
             }
         }
     }
 
-    QDateTime closeEnd = i.begin(), closeBegin = i.end();
-    Interval closedInterval;
-    for (const auto &rule : d->m_rules) {
-        if (rule->state() != Interval::Closed) {
+    auto closeEnd = i.begin, closeBegin = i.end;
+    LocalInterval closedInterval;
+    for (std::size_t ruleIndex = 0; ruleIndex < m_rules.size(); ++ruleIndex) {
+        if (m_rules[ruleIndex]->state() != Interval::Closed) {
             continue;
         }
-        const auto j = rule->nextInterval(i.begin().isValid() ? i.begin() : alignedTime, d.data()).interval;
+        const auto j = evaluateRule(ruleIndex, i.begin.isValid() ? i.begin : alignedTime, cursors).interval;
         if (!j.isValid() || !i.intersects(j)) {
             continue;
         }
@@ -566,38 +744,40 @@ Interval OpeningHours::interval(const QDateTime &dt) const
         if (j.contains(alignedTime)) {
             if (closedInterval.isValid()) {
                 // TODO we lose comment information here
-                closedInterval.setBegin(std::min(closedInterval.begin(), j.begin()));
-                closedInterval.setEnd(std::max(closedInterval.end(), j.end()));
+                closedInterval.begin = std::min(closedInterval.begin, j.begin);
+                closedInterval.end = std::max(closedInterval.end, j.end);
             } else {
                 closedInterval = j;
             }
-        } else if (alignedTime < j.begin()) {
-            closeBegin = std::min(j.begin(), closeBegin);
-        } else if (j.end() <= alignedTime) {
-            closeEnd = std::max(closeEnd, j.end());
+        } else if (alignedTime < j.begin) {
+            closeBegin = std::min(j.begin, closeBegin);
+        } else if (j.end <= alignedTime) {
+            closeEnd = std::max(closeEnd, j.end);
         }
     }
     if (closedInterval.isValid()) {
         i = closedInterval;
     } else {
-        i.setBegin(closeEnd);
-        i.setEnd(closeBegin);
+        i.begin = closeEnd;
+        i.end = closeBegin;
     }
 
     // check if the resulting interval contains dt, otherwise create a synthetic fallback interval
-    if (!i.isValid() || i.contains(dt)) {
-        return i;
+    if (!i.isValid() || i.contains(localTime)) {
+        return i.toInterval(m_comments);
     }
 
     Interval i2;
     i2.setState(Interval::Closed);
     i2.setBegin(dt);
-    i2.setEnd(i.begin());
+    i2.setEnd(i.begin.toDateTime());
     // TODO do we need to intersect this with closed rules as well?
     return i2;
 }
 
-Interval OpeningHours::nextInterval(const Interval &interval) const
+/** Returns the interval following @p interval, using @p evaluate to obtain the interval at a given time. */
+template <typename Evaluator>
+static Interval nextIntervalImpl(const Interval &interval, const Evaluator &evaluate)
 {
     if (!interval.hasOpenEnd()) {
         auto endDt = interval.end();
@@ -605,7 +785,7 @@ Interval OpeningHours::nextInterval(const Interval &interval) const
         if (interval.hasOpenEndTime() && interval.begin() == interval.end()) {
             endDt = endDt.addSecs(3600);
         }
-        auto i = this->interval(endDt);
+        auto i = evaluate(endDt);
         if (i.begin() < interval.end() && i.end() > interval.end()) {
             i.setBegin(interval.end());
         }
@@ -613,49 +793,301 @@ Interval OpeningHours::nextInterval(const Interval &interval) const
     }
     return {};
 }
+
+Interval OpeningHoursPrivate::evaluateNextInterval(const Interval &interval)
+{
+    return nextIntervalImpl(interval, [this](const QDateTime &dt) { return evaluateInterval(dt); });
+}
+
+void OpeningHoursPrivate::computeTimeline(Timeline &timeline, QDate end)
+{
+    const QDateTime endDt(end, {0, 0});
+    auto i = timeline.isEmpty() ? evaluateInterval(QDateTime(timeline.begin, {0, 0})) : evaluateNextInterval(timeline.lastInterval());
+    while (true) {
+        if (!i.isValid() || m_error != OpeningHours::NoError) {
+            timeline.isComplete = true;
+            break;
+        }
+        timeline.append(i);
+        if (i.hasOpenEnd()) {
+            timeline.isComplete = true;
+            break;
+        }
+        if (i.end() >= endDt) {
+            break;
+        }
+        i = evaluateNextInterval(i);
+    }
+    timeline.end = std::max(timeline.end, end);
+}
+
+Interval OpeningHoursPrivate::extendTimeline(const QDateTime &dt)
+{
+    QMutexLocker locker(&m_timelineMutex);
+    // check again if another thread extended this while we were waiting for the lock
+    const auto timeline = std::atomic_load(&m_timeline);
+    if (!timeline) {
+        return {};
+    }
+    auto i = timeline->interval(dt);
+    if (i.isValid() || !timeline->canExtendTo(dt)) {
+        return i;
+    }
+
+    auto newTimeline = std::make_shared<Timeline>(*timeline);
+    computeTimeline(*newTimeline, newTimeline->end.addDays(newTimeline->begin.daysTo(newTimeline->end)));
+    std::atomic_store(&m_timeline, std::shared_ptr<const Timeline>(newTimeline));
+    return newTimeline->interval(dt);
+}
+
+Interval OpeningHours::interval(const QDateTime &dt) const
+{
+    if (d->m_error != NoError) {
+        return {};
+    }
+
+    const StatisticsCollector::EvaluationSpan span;
+
+    if (const auto timeline = std::atomic_load(&d->m_timeline)) {
+        auto i = timeline->interval(dt);
+        if (!i.isValid() && timeline->canExtendTo(dt)) {
+            i = d->extendTimeline(dt);
+        }
+        if (i.isValid()) {
+            return i;
+        }
+    }
+
+    return d->evaluateInterval(dt);
+}
+
+Interval OpeningHours::nextInterval(const Interval &interval) const
+{
+    return nextIntervalImpl(interval, [this](const QDateTime &dt) { return this->interval(dt); });
+}
+
+QFuture<Interval> OpeningHours::intervalAsync(const QDateTime &dt) const
+{
+    return QtConcurrent::run([oh = *this, dt]() {
+        return oh.interval(dt);
+    });
+}
+
+namespace KOpeningHours {
+class OpeningHoursIteratorPrivate
+{
+public:
+    Interval evaluate(const QDateTime &dt)
+    {
+        // precomputed results are cheaper than anything we could do here
+        if (oh.d->m_error != OpeningHours::NoError || std::atomic_load(&oh.d->m_timeline)) {
+            return oh.interval(dt);
+        }
+        return oh.d->evaluateInterval(dt, &cursors);
+    }
+
+    OpeningHours oh;
+    Interval interval;
+    std::vector<RuleCursor> cursors;
+};
+}
+
+OpeningHours::Iterator::Iterator(const OpeningHours &openingHours, const QDateTime &dt)
+    : d(new OpeningHoursIteratorPrivate)
+{
+    d->oh = openingHours;
+    d->cursors.resize(openingHours.d->m_rules.size());
+    d->interval = d->evaluate(dt);
+}
+
+OpeningHours::Iterator::Iterator(Iterator&&) noexcept = default;
+OpeningHours::Iterator::~Iterator() = default;
+OpeningHours::Iterator& OpeningHours::Iterator::operator=(Iterator&&) noexcept = default;
+
+const Interval& OpeningHours::Iterator::interval() const
+{
+    return d->interval;
+}
+
+bool OpeningHours::Iterator::next()
+{
+    d->interval = nextIntervalImpl(d->interval, [this](const QDateTime &dt) { return d->evaluate(dt); });
+    return d->interval.isValid();
+}
+
+std::vector<Interval> OpeningHours::intervals(const QDateTime &from, const QDateTime &to) const
+{
+    std::vector<Interval> result;
+    intervals(from, to, result);
+    return result;
+}
+
+void OpeningHours::intervals(const QDateTime &from, const QDateTime &to, std::vector<Interval> &result) const
+{
+    result.clear();
+    if (d->m_error != NoError || !from.isValid() || !to.isValid() || to <= from) {
+        return;
+    }
+
+    // take as much as possible from the precomputed timeline without repeated lookups
+    if (const auto timeline = std::atomic_load(&d->m_timeline)) {
+        if (timeline->intervals(from, to, result)) {
+            return;
+        }
+    }
+
+    // same as Iterator: this still visits all rules for every interval, but only evaluates
+    // those again whose previous result has been passed
+    OpeningHoursIteratorPrivate it;
+    it.oh = *this;
+    it.cursors.resize(d->m_rules.size());
+    const auto evaluate = [&it](const QDateTime &dt) { return it.evaluate(dt); };
+    auto i = result.empty() ? it.evaluate(from) : nextIntervalImpl(result.back(), evaluate);
+    while (i.isValid()) {
+        result.push_back(i);
+        if (i.hasOpenEnd() || i.end() >= to) {
+            break;
+        }
+        i = nextIntervalImpl(i, evaluate);
+    }
+}
+
+void OpeningHours::precompute(QDate from, QDate to)
+{
+    detach();
+    d->m_timeline.reset();
+    if (d->m_error != NoError || !from.isValid() || !to.isValid() || to <= from) {
+        return;
+    }
+
+    auto timeline = std::make_shared<Timeline>();
+    timeline->begin = from;
+    timeline->end = from;
+    d->computeTimeline(*timeline, to);
+    if (d->m_error == NoError) {
+        d->m_timeline = std::move(timeline);
+    }
+}
 #endif
 
-static Rule* openingHoursSpecToRule(const QJsonObject &obj)
+namespace {
+/** The parts of a schema.org OpeningHoursSpecification we support. */
+struct OpeningHoursSpec {
+    inline bool hasSameTimes(const OpeningHoursSpec &other) const
+    {
+        return opens == other.opens && closes == other.closes && validFrom == other.validFrom && validThrough == other.validThrough;
+    }
+    inline bool overlaps(const OpeningHoursSpec &other) const
+    {
+        return days == 0 || other.days == 0 || (days & other.days);
+    }
+
+    QTime opens;
+    QTime closes;
+    QDate validFrom;
+    QDate validThrough;
+    // bit 0 for Monday to bit 6 for Sunday, bit 7 for public holidays, 0 if not limited to specific days
+    uint8_t days = 0;
+};
+}
+
+enum : uint8_t { PublicHolidaysBit = 1 << 7 };
+
+static uint8_t dayOfWeekBit(const QString &day)
+{
+    // schema.org DayOfWeek values, as plain names or as URLs
+    uint8_t bit = 1;
+    for (const auto &d : { "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday", "PublicHolidays" }) {
+        if (day.endsWith(QLatin1String(d))) {
+            return bit;
+        }
+        bit <<= 1;
+    }
+    return 0;
+}
+
+static bool parseOpeningHoursSpec(const QJsonObject &obj, OpeningHoursSpec &spec)
 {
     if (obj.value(QLatin1String("@type")).toString() != QLatin1String("OpeningHoursSpecification")) {
-        return nullptr;
+        return false;
     }
 
-    const auto opens = QTime::fromString(obj.value(QLatin1String("opens")).toString());
-    const auto closes = QTime::fromString(obj.value(QLatin1String("closes")).toString());
+    spec.opens = QTime::fromString(obj.value(QLatin1String("opens")).toString());
+    spec.closes = QTime::fromString(obj.value(QLatin1String("closes")).toString());
+    if (!spec.opens.isValid() || !spec.closes.isValid()) {
+        return false;
+    }
+
+    spec.validFrom = QDate::fromString(obj.value(QLatin1String("validFrom")).toString(), Qt::ISODate);
+    spec.validThrough = QDate::fromString(obj.value(QLatin1String("validThrough")).toString(), Qt::ISODate);
+
+    const auto dayOfWeek = obj.value(QLatin1String("dayOfWeek"));
+    for (const auto &dayV : dayOfWeek.isArray() ? dayOfWeek.toArray() : QJsonArray({ dayOfWeek })) {
+        const auto day = dayV.toString();
+        if (day.isEmpty()) {
+            continue;
+        }
+        const auto bit = dayOfWeekBit(day);
+        if (!bit) {
+            return false;
+        }
+        spec.days |= bit;
+    }
+    return true;
+}
 
-    if (!opens.isValid() || !closes.isValid()) {
-        return nullptr;
+/** Adds @p spec to @p specs, merged into an existing one with the same times where possible. */
+static void addOpeningHoursSpec(std::vector<OpeningHoursSpec> &specs, const OpeningHoursSpec &spec)
+{
+    // later rules take precedence over earlier ones for the same days, so an earlier spec can only
+    // absorb this one if none of the specs in between applies to any of the same days
+    for (auto it = specs.rbegin(); it != specs.rend(); ++it) {
+        if ((*it).hasSameTimes(spec)) {
+            (*it).days = ((*it).days && spec.days) ? ((*it).days | spec.days) : 0;
+            return;
+        }
+        if ((*it).overlaps(spec)) {
+            break;
+        }
     }
+    specs.push_back(spec);
+}
 
-    auto r = new Rule;
+static Rule* openingHoursSpecToRule(const OpeningHoursSpec &spec, AstArena &arena)
+{
+    auto r = arena.create<Rule>();
     r->setState(State::Open);
     // ### is name or description used for comments?
 
-    r->m_timeSelector.reset(new Timespan);
-    r->m_timeSelector->begin = { Time::NoEvent, opens.hour(), opens.minute() };
-    r->m_timeSelector->end = { Time::NoEvent, closes.hour(), closes.minute() };
-
-    const auto validFrom = QDate::fromString(obj.value(QLatin1String("validFrom")).toString(), Qt::ISODate);
-    const auto validTo = QDate::fromString(obj.value(QLatin1String("validThrough")).toString(), Qt::ISODate);
-    if (validFrom.isValid() || validTo.isValid()) {
-        r->m_monthdaySelector.reset(new MonthdayRange);
-        r->m_monthdaySelector->begin = { validFrom.year(), validFrom.month(), validFrom.day(), Date::FixedDate, { 0, 0, 0 } };
-        r->m_monthdaySelector->end = { validTo.year(), validTo.month(), validTo.day(), Date::FixedDate, { 0, 0, 0 } };
-    }
-
-    const auto weekday = obj.value(QLatin1String("dayOfWeek")).toString();
-    if (!weekday.isEmpty()) {
-        r->m_weekdaySelector.reset(new WeekdayRange);
-        int i = 1;
-        for (const auto &d : { "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"}) {
-            if (weekday.endsWith(QLatin1String(d))) {
-                r->m_weekdaySelector->beginDay = r->m_weekdaySelector->endDay = i;
-                break;
-            }
-            ++i;
+    r->m_timeSelector = arena.create<Timespan>();
+    r->m_timeSelector->begin = { Time::NoEvent, spec.opens.hour(), spec.opens.minute() };
+    r->m_timeSelector->end = { Time::NoEvent, spec.closes.hour(), spec.closes.minute() };
+
+    if (spec.validFrom.isValid() || spec.validThrough.isValid()) {
+        r->m_monthdaySelector = arena.create<MonthdayRange>();
+        r->m_monthdaySelector->begin = { spec.validFrom.year(), spec.validFrom.month(), spec.validFrom.day(), Date::FixedDate, { 0, 0, 0 } };
+        r->m_monthdaySelector->end = { spec.validThrough.year(), spec.validThrough.month(), spec.validThrough.day(), Date::FixedDate, { 0, 0, 0 } };
+    }
+
+    WeekdayRange *last = nullptr;
+    for (int day = 1; day <= 7; ++day) {
+        if (spec.days & (1 << (day - 1))) {
+            auto selector = arena.create<WeekdayRange>();
+            selector->beginDay = selector->endDay = day;
+            (last ? last->next : r->m_weekdaySelector) = selector;
+            last = selector;
         }
     }
+    if (r->m_weekdaySelector) {
+        // turns consecutive days into ranges
+        r->m_weekdaySelector->simplify(arena);
+        for (last = r->m_weekdaySelector; last->next; last = last->next) {}
+    }
+    if (spec.days & PublicHolidaysBit) {
+        auto selector = arena.create<WeekdayRange>();
+        selector->holiday = WeekdayRange::PublicHoliday;
+        (last ? last->next : r->m_weekdaySelector) = selector;
+    }
 
     return r;
 }
@@ -663,44 +1095,67 @@ static Rule* openingHoursSpecToRule(const QJsonObject &obj)
 OpeningHours OpeningHours::fromJsonLd(const QJsonObject &obj)
 {
     OpeningHours result;
+    const auto d = result.d.data();
 
+    // array entries are parsed one after the other into the same rule list,
+    // joining them into a single expression first would only cost another copy
+    auto &stats = d->m_parseStatistics;
     const auto oh = obj.value(QLatin1String("openingHours"));
-    if (oh.isString()) {
-        result = OpeningHours(oh.toString().toUtf8());
-    } else if (oh.isArray()) {
-        const auto ohA = oh.toArray();
-        QByteArray expr;
-        for (const auto &exprV : ohA) {
-            const auto exprS = exprV.toString();
-            if (exprS.isEmpty()) {
-                continue;
-            }
-            expr += (expr.isEmpty() ? "" : "; ") + exprS.toUtf8();
+    for (const auto &exprV : oh.isArray() ? oh.toArray() : QJsonArray({ oh })) {
+        const auto expr = exprV.toString().toUtf8();
+        const auto size = trimmedSize(expr.constData(), expr.size());
+        if (size == 0) {
+            continue;
         }
-        result = OpeningHours(expr);
-    }
-
-    std::vector<std::unique_ptr<Rule>> rules;
-    const auto ohs = obj.value(QLatin1String("openingHoursSpecification")).toArray();
-    for (const auto &ohsV : ohs) {
-        const auto r = openingHoursSpecToRule(ohsV.toObject());
-        if (r) {
-            rules.push_back(std::unique_ptr<Rule>(r));
+        if (!parseRules(d, expr.constData(), size, stats)) {
+            break;
         }
     }
-    const auto sohs = obj.value(QLatin1String("specialOpeningHoursSpecification")).toArray();
-    for (const auto &ohsV : sohs) {
-        const auto r = openingHoursSpecToRule(ohsV.toObject());
-        if (r) {
-            rules.push_back(std::unique_ptr<Rule>(r));
+    d->assignCommentIds();
+    d->autocorrect();
+
+    // specifications are turned into rules directly, merging identical times on different days into one rule
+    std::vector<OpeningHoursSpec> specs;
+    for (const auto key : { "openingHoursSpecification", "specialOpeningHoursSpecification" }) {
+        const auto specsA = obj.value(QLatin1String(key)).toArray();
+        for (const auto &specV : specsA) {
+            OpeningHoursSpec spec;
+            if (parseOpeningHoursSpec(specV.toObject(), spec)) {
+                addOpeningHoursSpec(specs, spec);
+            }
         }
     }
-    for (auto &r : rules) {
-        result.d->m_rules.push_back(std::move(r));
+    for (const auto &spec : specs) {
+        d->m_rules.push_back(openingHoursSpecToRule(spec, *d->m_arena));
     }
 
-    result.d->validate();
+    d->validate();
     return result;
 }
 
+// converting an object involves JSON lookups and parsing its expression, which is several times
+// more expensive than evaluating an expression (see BatchEvaluator), so smaller chunks pay off here
+enum { MinimumJsonLdJobSize = 64 };
+
+void OpeningHours::fromJsonLd(const QJsonObject *objects, std::size_t count, OpeningHours *results)
+{
+    ThreadPool::forEachChunk(count, MinimumJsonLdJobSize, [objects, results](std::size_t offset, std::size_t chunk) {
+        for (auto i = offset; i < offset + chunk; ++i) {
+            results[i] = fromJsonLd(objects[i]);
+        }
+    });
+}
+
+std::vector<OpeningHours> OpeningHours::fromJsonLd(const QJsonArray &objects)
+{
+    std::vector<QJsonObject> objs;
+    objs.reserve(objects.size());
+    for (const auto &objV : objects) {
+        objs.push_back(objV.toObject());
+    }
+    std::vector<OpeningHours> results(objs.size());
+    fromJsonLd(objs.data(), objs.size(), results.data());
+    return results;
+}
+
 #include "moc_openinghours.cpp"
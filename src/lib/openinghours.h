@@ -10,10 +10,18 @@
 #include "kopeninghours_export.h"
 
 #include <QExplicitlySharedDataPointer>
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+#include <QFuture>
+#endif
 #include <QMetaType>
 
+#include <memory>
+#include <vector>
+
 class QByteArray;
+class QDate;
 class QDateTime;
+class QJsonArray;
 class QJsonObject;
 class QString;
 class QTimeZone;
@@ -23,10 +31,18 @@ namespace KOpeningHours {
 
 class Interval;
 class OpeningHoursPrivate;
+class OpeningHoursIteratorPrivate;
 
 /** An OSM opening hours specification.
  *  This is the main entry point into this library, providing both a way to parse opening hours expressions
  *  and to evaluate them.
+ *
+ *  Evaluating an expression (that is, calling interval() or nextInterval()) is thread-safe,
+ *  on distinct instances as well as on the same @c const instance shared between threads.
+ *  Modifying an instance (by calling setExpression(), setLocation(), setRegion(), setTimeZone() or precompute())
+ *  is not, and as OpeningHours is explicitly shared this also affects all copies of that instance.
+ *  The exception to this are instances obtained from an ExpressionCache, which are copy-on-write.
+ *
  *  @see https://wiki.openstreetmap.org/wiki/Key:opening_hours
  */
 class KOPENINGHOURS_EXPORT OpeningHours
@@ -85,6 +101,21 @@ public:
      */
     void setExpression(const char *openingHours, std::size_t size, Modes modes = IntervalMode);
 
+    /** Diagnostic information about processing an expression in setExpression().
+     *  Times are only measured when the library is built with the @c ENABLE_STATISTICS CMake option,
+     *  and are zero otherwise.
+     */
+    struct ParseStatistics {
+        qint64 parseTime = 0; ///< Time spent parsing, including error recovery, in nanoseconds.
+        qint64 autocorrectTime = 0; ///< Time spent on correcting common mistakes, in nanoseconds.
+        qint64 validateTime = 0; ///< Time spent on validating the parsed expression, in nanoseconds.
+        int restartCount = 0; ///< Number of times the parser had to restart for error recovery.
+    };
+    /** Statistics of the setExpression() call that produced the expression of this instance.
+     *  This is meant for finding expressions that are particularly expensive to process.
+     */
+    ParseStatistics parseStatistics() const;
+
     /** Returns the OSM opening hours expression reconstructed from this object.
      * In many cases it will be the same as the expression given to the constructor
      * or to setExpression, but some normalization can happen as well, especially in
@@ -98,6 +129,20 @@ public:
      */
     QByteArray simplifiedExpression() const;
 
+    /** Binary representation of the parsed expression, for restoring it with deserialize().
+     *  This includes the location, region and time zone, but no evaluation results.
+     *  The format is versioned and position-independent, so it can be stored in files and
+     *  loaded again from memory-mapped data.
+     */
+    QByteArray serialize() const;
+    /** Restores an expression previously stored with serialize(), without parsing it.
+     *  @returns @c false if @p data is invalid or of an incompatible format version,
+     *  in which case this instance is left empty.
+     */
+    bool deserialize(const QByteArray &data);
+    /** Same as the above, for use with memory-mapped data. */
+    bool deserialize(const char *data, std::size_t size);
+
     /** Geographic coordinate at which this expression should be evaluated.
      *  This is needed for expressions containing location-based variable time references,
      *  such as "sunset". If the expression requires a location, error() returns @c MissingLocation
@@ -147,6 +192,63 @@ public:
     Q_INVOKABLE KOpeningHours::Interval interval(const QDateTime &dt) const;
     /** Returns the interval immediately following @p interval. */
     Q_INVOKABLE KOpeningHours::Interval nextInterval(const KOpeningHours::Interval &interval) const;
+
+    /** Asynchronous variant of interval(), evaluated on the global thread pool.
+     *  This is useful for UI code, as the first evaluation of expressions referring to
+     *  public holidays can involve loading holiday data. The expression must not be
+     *  modified until the result is available.
+     */
+    QFuture<KOpeningHours::Interval> intervalAsync(const QDateTime &dt) const;
+
+    /** Returns all intervals overlapping with [@p from, @p to).
+     *  This is the same as the sequence obtained by calling interval() for @p from and then
+     *  nextInterval() until reaching @p to. Precomputed results (see precompute()) are used
+     *  directly for this, without looking up each interval individually.
+     *  Otherwise this works like Iterator: each resulting interval still checks all rules, but
+     *  rules are only evaluated again once the range has passed their previous result, so the
+     *  cost for rules not matching inside the range doesn't grow with the number of intervals.
+     */
+    std::vector<KOpeningHours::Interval> intervals(const QDateTime &from, const QDateTime &to) const;
+    /** Same as the above, but reusing the storage of @p result. */
+    void intervals(const QDateTime &from, const QDateTime &to, std::vector<KOpeningHours::Interval> &result) const;
+
+    /** Forward iteration over consecutive intervals.
+     *  This yields the same intervals as calling interval() and then repeatedly nextInterval(),
+     *  but keeps the last result of each rule of the expression between steps. Rules whose
+     *  result is still current for the next step are not evaluated again, which makes a big
+     *  difference for expressions with many rules.
+     *  The expression must not be modified while iterating over it.
+     */
+    class KOPENINGHOURS_EXPORT Iterator
+    {
+    public:
+        /** Start iteration at the interval containing @p dt. */
+        explicit Iterator(const OpeningHours &openingHours, const QDateTime &dt);
+        Iterator(Iterator&&) noexcept;
+        ~Iterator();
+        Iterator& operator=(Iterator&&) noexcept;
+
+        /** The current interval, invalid once there are no further intervals. */
+        const KOpeningHours::Interval& interval() const;
+        /** Advance to the next interval.
+         *  @returns @c false if there is no further interval.
+         */
+        bool next();
+
+    private:
+        Q_DISABLE_COPY(Iterator)
+        std::unique_ptr<OpeningHoursIteratorPrivate> d;
+    };
+
+    /** Precomputes all intervals from @p from until @p to.
+     *  This speeds up interval() and nextInterval() for times in that range, which is useful
+     *  when repeatedly evaluating the same expression. Queries shortly after that range
+     *  extend it as needed.
+     *  For times inside that range, interval() returns the intervals you would get by iterating
+     *  with nextInterval() from @p from, which can have an earlier begin than without precomputation.
+     *  Changing the expression, location, region or time zone discards precomputed results.
+     */
+    void precompute(QDate from, QDate to);
 #endif
 
     /** Convert opening hours in schema.org JSON-LD format.
@@ -156,6 +258,15 @@ public:
      *  - https://schema.org/specialOpeningHoursSpecification
      */
     static OpeningHours fromJsonLd(const QJsonObject &obj);
+    /** Convert @p count JSON-LD objects starting at @p objects, see above.
+     *  @param results Preallocated array of at least @p count elements, the result for
+     *  the object at index @c i is written to index @c i.
+     *  Large amounts of objects are converted in parallel on the global thread pool. Large
+     *  documents can be processed by passing their objects in chunks of any size.
+     */
+    static void fromJsonLd(const QJsonObject *objects, std::size_t count, OpeningHours *results);
+    /** Convert all JSON-LD objects in @p objects, see above. */
+    static std::vector<OpeningHours> fromJsonLd(const QJsonArray &objects);
 
 private:
     // for QML bindings
@@ -163,6 +274,12 @@ private:
     Q_DECL_HIDDEN QString timeZoneId() const;
     Q_DECL_HIDDEN void setTimeZoneId(const QString &tzId);
 
+    friend class ExpressionCache;
+    friend class IntervalModelPrivate;
+    friend class OpeningHoursIteratorPrivate;
+    friend class WeeklyBitmapStore;
+    Q_DECL_HIDDEN void detach();
+
     QExplicitlySharedDataPointer<OpeningHoursPrivate> d;
 };
 
@@ -7,34 +7,96 @@
 #ifndef KOPENINGHOURS_OPENINGHOURS_P_H
 #define KOPENINGHOURS_OPENINGHOURS_P_H
 
+#include "astarena_p.h"
 #include "openinghours.h"
 #include "rule_p.h"
 
 #ifndef KOPENINGHOURS_VALIDATOR_ONLY
+#include "timeline_p.h"
+#include "timezonecache_p.h"
+#include "weeklyschedule_p.h"
+
 #include <KHolidays/HolidayRegion>
+
+#include <QHash>
+#include <QMutex>
 #endif
 
 #include <QSharedData>
 #include <QTimeZone>
 
+#include <atomic>
 #include <cmath>
 #include <memory>
 #include <vector>
 
 namespace KOpeningHours {
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+/** Last evaluation result of a single rule, used by OpeningHours::Iterator. */
+struct RuleCursor {
+    /** Checks whether evaluating the rule at @p dt would yield the same interval again.
+     *  Time selectors don't produce anything different for later times on the same day until
+     *  the current result has been passed. Days after that until the day the result begins
+     *  don't match the date selectors, otherwise the rule would have produced an interval there.
+     */
+    inline bool covers(LocalDateTime dt) const
+    {
+        if (!result.interval.isValid() || !result.interval.end.isValid() || dt < queryTime || dt >= result.interval.end) {
+            return false;
+        }
+        return queryTime.date() == dt.date() || (result.interval.begin.isValid() && dt.date() < result.interval.begin.date());
+    }
+    /** The result of evaluating the rule at @p dt, assuming covers(@p dt).
+     *  Rules only override the preceding ones on the days their date selectors match,
+     *  so results reused on a later day are merged, same as a new evaluation would do.
+     */
+    inline RuleResult resultAt(LocalDateTime dt) const
+    {
+        return queryTime.date() == dt.date() ? result : RuleResult{ result.interval, RuleResult::Merge };
+    }
+
+    LocalDateTime queryTime;
+    RuleResult result;
+};
+#endif
+
 class OpeningHoursPrivate : public QSharedData {
 public:
+    /** Copy sharing the syntax tree with this instance. */
+    OpeningHoursPrivate* clone() const;
     void finalizeRecovery();
     void autocorrect();
     void simplify();
     void validate();
+    /** Assigns the rule comment ids used during evaluation, after new rules have been created. */
+    void assignCommentIds();
     void addRule(Rule *parsedRule);
     void restartFrom(int pos, Rule::Type nextRuleType);
     bool isRecovering() const;
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+    /** Evaluation without considering the precomputed timeline.
+     *  @param cursors Per-rule results of previous evaluations to reuse where possible, for forward iteration.
+     */
+    Interval evaluateInterval(const QDateTime &dt, std::vector<RuleCursor> *cursors = nullptr);
+    Interval evaluateNextInterval(const Interval &interval);
+    /** Appends intervals to @p timeline until it covers @p end. */
+    void computeTimeline(Timeline &timeline, QDate end);
+    Interval extendTimeline(const QDateTime &dt);
+    /** Wall clock time of @p event on @p date, at the location and in the time zone of this expression. */
+    LocalDateTime sunEvent(Time::Event event, QDate date);
+    RuleResult evaluateRule(std::size_t ruleIndex, LocalDateTime dt, std::vector<RuleCursor> *cursors);
+#endif
 
-    std::vector<std::unique_ptr<Rule>> m_rules;
+    // owns all rules and selectors, m_rules are non-owning
+    // shared between cached instances and their detached copies
+    std::shared_ptr<AstArena> m_arena = std::make_shared<AstArena>();
+    std::vector<Rule*> m_rules;
+    // distinct rule comments, index 0 is the empty string
+    std::vector<QString> m_comments{ QString() };
     OpeningHours::Modes m_modes = OpeningHours::IntervalMode;
-    OpeningHours::Error m_error = OpeningHours::NoError;
+    // atomic as evaluation on const instances can set this from multiple threads
+    std::atomic<OpeningHours::Error> m_error{OpeningHours::NoError};
+    OpeningHours::ParseStatistics m_parseStatistics;
 
     float m_latitude = NAN;
     float m_longitude = NAN;
@@ -42,8 +104,25 @@ public:
     Rule::Type m_initialRuleType = Rule::NormalRule;
     Rule::Type m_recoveryRuleType = Rule::NormalRule;
     bool m_ruleSeparatorRecovery = false;
+    // owned by an ExpressionCache, needs to be detached before modification
+    bool m_cached = false;
 #ifndef KOPENINGHOURS_VALIDATOR_ONLY
     KHolidays::HolidayRegion m_region;
+    WeeklySchedule m_weeklySchedule;
+    // Rule::endDate() of all rules, rules that ended before the evaluated time don't need to be evaluated
+    std::vector<QDate> m_ruleEndDates;
+    // accessed atomically as evaluation on const instances can extend this from multiple threads
+    std::shared_ptr<const Timeline> m_timeline;
+    QMutex m_timelineMutex;
+    // sun events per Julian day, computing those dominates evaluation of sun-based expressions otherwise
+    struct SunEvents {
+        LocalDateTime events[4];
+        quint8 resolved = 0; // bit mask of the memoized events
+    };
+    QHash<qint64, SunEvents> m_sunEvents;
+    // UTC offsets of m_timezone, looked up on first use, also protected by m_sunEventMutex
+    std::shared_ptr<const TimeZoneCache::Table> m_timezoneTable;
+    QMutex m_sunEventMutex;
 #endif
     QTimeZone m_timezone = QTimeZone::systemTimeZone();
 };
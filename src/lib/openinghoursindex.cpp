@@ -0,0 +1,224 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "openinghoursindex.h"
+#include "interval.h"
+#include "openinghours.h"
+#include "slotmap_p.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+#include <iterator>
+
+using namespace KOpeningHours;
+
+enum : qint64 { BucketSize = 3600 * 1000 }; // one hour, in milliseconds
+
+namespace KOpeningHours {
+class OpeningHoursIndexPrivate
+{
+public:
+    /** Open interval of an entry, times in milliseconds since epoch. */
+    struct Item {
+        qint64 begin;
+        qint64 end;
+        quint32 slot;
+        quint32 generation;
+    };
+
+    inline bool isLive(const Item &item) const
+    {
+        return slots.isLive(item.slot, item.generation);
+    }
+    inline std::size_t bucket(qint64 msecs) const
+    {
+        return static_cast<std::size_t>((msecs - begin) / BucketSize);
+    }
+    inline bool inWindow(qint64 msecs) const
+    {
+        return msecs >= begin && msecs < end;
+    }
+
+    void addItems(quint32 slot);
+    void compactIfNeeded();
+    void openSlots(qint64 msecs, std::vector<quint32> &result) const;
+
+    qint64 begin = 0;
+    qint64 end = 0;
+    // intervals overlapping with the bucket's hour, and intervals beginning in the bucket's hour
+    std::vector<std::vector<Item>> openBuckets;
+    std::vector<std::vector<Item>> startBuckets;
+
+    SlotMap<OpeningHours> slots;
+};
+}
+
+void OpeningHoursIndexPrivate::addItems(quint32 slot)
+{
+    auto &s = slots[slot];
+    if (s.value.error() != OpeningHours::NoError || begin >= end) {
+        return;
+    }
+
+    std::size_t itemCount = 0;
+    for (const auto &interval : s.value.intervals(QDateTime::fromMSecsSinceEpoch(begin), QDateTime::fromMSecsSinceEpoch(end))) {
+        if (interval.state() != Interval::Open) {
+            continue;
+        }
+        const auto hasBegin = interval.begin().isValid() && interval.begin().toMSecsSinceEpoch() >= begin;
+        const auto b = hasBegin ? interval.begin().toMSecsSinceEpoch() : begin;
+        const auto e = interval.end().isValid() ? std::min(end, interval.end().toMSecsSinceEpoch()) : end;
+        if (b >= e) {
+            continue;
+        }
+
+        const Item item{ b, e, slot, s.generation };
+        for (auto k = bucket(b); k <= bucket(e - 1); ++k) {
+            openBuckets[k].push_back(item);
+            ++itemCount;
+        }
+        if (hasBegin) {
+            startBuckets[bucket(b)].push_back(item);
+            ++itemCount;
+        }
+    }
+    slots.addItems(slot, itemCount);
+}
+
+void OpeningHoursIndexPrivate::compactIfNeeded()
+{
+    if (!slots.needsCompaction()) {
+        return;
+    }
+
+    const auto isStale = [this](const Item &item) { return !isLive(item); };
+    for (auto buckets : { &openBuckets, &startBuckets }) {
+        for (auto &bucket : *buckets) {
+            bucket.erase(std::remove_if(bucket.begin(), bucket.end(), isStale), bucket.end());
+        }
+    }
+    slots.compacted();
+}
+
+void OpeningHoursIndexPrivate::openSlots(qint64 msecs, std::vector<quint32> &result) const
+{
+    for (const auto &item : openBuckets[bucket(msecs)]) {
+        if (item.begin <= msecs && msecs < item.end && isLive(item)) {
+            result.push_back(item.slot);
+        }
+    }
+}
+
+OpeningHoursIndex::OpeningHoursIndex(const QDateTime &begin, const QDateTime &end)
+    : d(new OpeningHoursIndexPrivate)
+{
+    setWindow(begin, end);
+}
+
+OpeningHoursIndex::~OpeningHoursIndex() = default;
+
+void OpeningHoursIndex::insert(Id id, const OpeningHours &openingHours)
+{
+    const auto slot = d->slots.insert(id);
+    d->slots[slot].value = openingHours;
+    d->addItems(slot);
+    d->compactIfNeeded();
+}
+
+void OpeningHoursIndex::remove(Id id)
+{
+    if (d->slots.remove(id)) {
+        d->compactIfNeeded();
+    }
+}
+
+bool OpeningHoursIndex::contains(Id id) const
+{
+    return d->slots.contains(id);
+}
+
+std::size_t OpeningHoursIndex::size() const
+{
+    return d->slots.size();
+}
+
+QDateTime OpeningHoursIndex::windowBegin() const
+{
+    return QDateTime::fromMSecsSinceEpoch(d->begin);
+}
+
+QDateTime OpeningHoursIndex::windowEnd() const
+{
+    return QDateTime::fromMSecsSinceEpoch(d->end);
+}
+
+void OpeningHoursIndex::setWindow(const QDateTime &begin, const QDateTime &end)
+{
+    d->begin = begin.toMSecsSinceEpoch();
+    d->end = std::max(d->begin, end.toMSecsSinceEpoch());
+    const auto bucketCount = static_cast<std::size_t>((d->end - d->begin + BucketSize - 1) / BucketSize);
+    d->openBuckets.clear();
+    d->openBuckets.resize(bucketCount);
+    d->startBuckets.clear();
+    d->startBuckets.resize(bucketCount);
+    d->slots.resetItems();
+
+    for (quint32 slot = 0; slot < d->slots.slotCount(); ++slot) {
+        if (d->slots[slot].used) {
+            d->addItems(slot);
+        }
+    }
+}
+
+std::vector<OpeningHoursIndex::Id> OpeningHoursIndex::openAt(const QDateTime &dt) const
+{
+    const auto msecs = dt.toMSecsSinceEpoch();
+    if (!d->inWindow(msecs)) {
+        return {};
+    }
+
+    // intervals of the same entry don't overlap, so this can't contain duplicates
+    std::vector<quint32> slots;
+    d->openSlots(msecs, slots);
+    std::vector<Id> result;
+    result.reserve(slots.size());
+    std::transform(slots.begin(), slots.end(), std::back_inserter(result), [this](quint32 slot) { return d->slots[slot].id; });
+    return result;
+}
+
+std::vector<OpeningHoursIndex::Id> OpeningHoursIndex::opensWithin(const QDateTime &dt, qint64 seconds) const
+{
+    const auto msecs = dt.toMSecsSinceEpoch();
+    if (!d->inWindow(msecs) || seconds <= 0) {
+        return {};
+    }
+    const auto endMsecs = std::min(d->end - 1, msecs + seconds * 1000);
+
+    std::vector<quint32> opening;
+    for (auto k = d->bucket(msecs); k <= d->bucket(endMsecs); ++k) {
+        for (const auto &item : d->startBuckets[k]) {
+            if (item.begin > msecs && item.begin <= endMsecs && d->isLive(item)) {
+                opening.push_back(item.slot);
+            }
+        }
+    }
+    std::sort(opening.begin(), opening.end());
+    opening.erase(std::unique(opening.begin(), opening.end()), opening.end());
+
+    std::vector<quint32> open;
+    d->openSlots(msecs, open);
+    std::sort(open.begin(), open.end());
+
+    std::vector<Id> result;
+    for (auto it = opening.begin(), openIt = open.begin(); it != opening.end(); ++it) {
+        openIt = std::lower_bound(openIt, open.end(), *it);
+        if (openIt == open.end() || *openIt != *it) {
+            result.push_back(d->slots[*it].id);
+        }
+    }
+    return result;
+}
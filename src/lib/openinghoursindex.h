@@ -0,0 +1,76 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_OPENINGHOURSINDEX_H
+#define KOPENINGHOURS_OPENINGHOURSINDEX_H
+
+#include "kopeninghours_export.h"
+
+#include <QtGlobal>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class QDateTime;
+
+namespace KOpeningHours {
+
+class OpeningHours;
+class OpeningHoursIndexPrivate;
+
+/** Time index over a collection of opening hours expressions.
+ *  The open intervals of all entries within a fixed time window are computed upfront,
+ *  and stored in per-hour buckets. Queries then only need to look at the entries that
+ *  are open in the hour in question, rather than evaluating all entries.
+ *
+ *  Entries can be added, replaced or removed individually without rebuilding the index.
+ *  Queries outside of the time window return no results, use setWindow() to move the window.
+ *  The query methods of this class are thread-safe, modifying the index is not.
+ */
+class KOPENINGHOURS_EXPORT OpeningHoursIndex
+{
+public:
+    /** Application-defined identifier of an entry, e.g. an OSM element id. */
+    using Id = quint64;
+
+    /** Creates an empty index for the time window from @p begin until @p end. */
+    explicit OpeningHoursIndex(const QDateTime &begin, const QDateTime &end);
+    ~OpeningHoursIndex();
+
+    /** Adds @p openingHours as entry @p id, replacing a previous entry with the same id. */
+    void insert(Id id, const OpeningHours &openingHours);
+    /** Removes entry @p id, if present. */
+    void remove(Id id);
+    /** Returns @c true if there is an entry @p id. */
+    bool contains(Id id) const;
+    /** Amount of entries in this index. */
+    std::size_t size() const;
+
+    /** Begin of the indexed time window. */
+    QDateTime windowBegin() const;
+    /** End of the indexed time window. */
+    QDateTime windowEnd() const;
+    /** Changes the indexed time window to the range from @p begin until @p end.
+     *  This recomputes the intervals of all entries.
+     */
+    void setWindow(const QDateTime &begin, const QDateTime &end);
+
+    /** Ids of all entries that are open at @p dt, in no particular order. */
+    std::vector<Id> openAt(const QDateTime &dt) const;
+    /** Ids of all entries that are not open at @p dt, but open within the following @p seconds.
+     *  The result is in no particular order.
+     */
+    std::vector<Id> opensWithin(const QDateTime &dt, qint64 seconds) const;
+
+private:
+    Q_DISABLE_COPY(OpeningHoursIndex)
+    std::unique_ptr<OpeningHoursIndexPrivate> d;
+};
+
+}
+
+#endif // KOPENINGHOURS_OPENINGHOURSINDEX_H
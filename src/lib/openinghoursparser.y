@@ -33,23 +33,23 @@ static void initSelectors(Selectors &sels)
 
 static void applySelectors(const Selectors &sels, Rule *rule)
 {
-    rule->m_timeSelector.reset(sels.timeSelector);
-    rule->m_weekdaySelector.reset(sels.weekdaySelector);
-    rule->m_weekSelector.reset(sels.weekSelector);
-    rule->m_monthdaySelector.reset(sels.monthdaySelector);
-    rule->m_yearSelector.reset(sels.yearSelector);
+    rule->m_timeSelector = sels.timeSelector;
+    rule->m_weekdaySelector = sels.weekdaySelector;
+    rule->m_weekSelector = sels.weekSelector;
+    rule->m_monthdaySelector = sels.monthdaySelector;
+    rule->m_yearSelector = sels.yearSelector;
     rule->m_seen_24_7 = sels.seen_24_7;
     rule->m_colonAfterWideRangeSelector = sels.colonAfterWideRangeSelector;
     rule->m_wideRangeSelectorComment = QString::fromUtf8(sels.wideRangeSelectorComment.str, sels.wideRangeSelectorComment.len);
 }
 
-static bool extendMonthdaySelector(MonthdayRange *monthdaySelector, int beginDay, int endDay)
+static bool extendMonthdaySelector(OpeningHoursPrivate *parser, MonthdayRange *monthdaySelector, int beginDay, int endDay)
 {
     const auto prevSelector = lastSelector(monthdaySelector);
     if (prevSelector->begin.year == prevSelector->end.year
      && prevSelector->begin.month == prevSelector->end.month)
     {
-        auto sel = new MonthdayRange;
+        auto sel = parser->m_arena->create<MonthdayRange>();
         sel->begin = sel->end = prevSelector->end;
         sel->begin.day = beginDay;
         sel->end.day = endDay;
@@ -205,20 +205,7 @@ typedef void* yyscan_t;
 %type <yearRange> YearRange
 %type <yearRange> YearRangeStandalone
 
-%destructor { delete $$; } <rule>
-%destructor {
-    delete $$.timeSelector;
-    delete $$.weekdaySelector;
-    delete $$.weekSelector;
-    delete $$.monthdaySelector;
-    delete $$.yearSelector;
-} <selectors>
-%destructor { delete $$; } <timespan>
-%destructor { delete $$; } <nthSequence>
-%destructor { delete $$; } <weekdayRange>
-%destructor { delete $$; } <week>
-%destructor { delete $$; } <monthdayRange>
-%destructor { delete $$; } <yearRange>
+// all rules and selectors are owned by OpeningHoursPrivate::m_arena, so no %destructor is needed
 
 // resolve SR conflict between the YearSelector and MonthdaySelector on T_YEAR T_MONTH
 %nonassoc T_YEAR
@@ -262,35 +249,35 @@ Ruleset:
 
 Rule:
   SelectorSequence[S] {
-    $$ = new Rule;
+    $$ = parser->m_arena->create<Rule>();
     applySelectors($S, $$);
   }
 | SelectorSequence[S] T_COMMENT[C] {
-    $$ = new Rule;
+    $$ = parser->m_arena->create<Rule>();
     $$->setComment($C.str, $C.len);
     applySelectors($S, $$);
   }
 | SelectorSequence[S] T_STATE[T] {
-    $$ = new Rule;
+    $$ = parser->m_arena->create<Rule>();
     $$->setState($T);
     applySelectors($S, $$);
   }
 | SelectorSequence[S] T_STATE[T] T_COMMENT[C] {
-    $$ = new Rule;
+    $$ = parser->m_arena->create<Rule>();
     $$->setComment($C.str, $C.len);
     $$->setState($T);
     applySelectors($S, $$);
   }
 | T_COMMENT[C] {
-    $$ = new Rule;
+    $$ = parser->m_arena->create<Rule>();
     $$->setComment($C.str, $C.len);
   }
 | T_STATE[T] {
-    $$ = new Rule;
+    $$ = parser->m_arena->create<Rule>();
     $$->setState($T);
   }
 | T_STATE[T] T_COMMENT[C] {
-    $$ = new Rule;
+    $$ = parser->m_arena->create<Rule>();
     $$->setComment($C.str, $C.len);
     $$->setState($T);
   }
@@ -383,35 +370,35 @@ TimeSelector:
 
 Timespan:
   Time[T] {
-    $$ = new Timespan;
+    $$ = parser->m_arena->create<Timespan>();
     $$->begin = $$->end = $T;
     $$->pointInTime = true;
   }
 | Time[T] T_PLUS {
-    $$ = new Timespan;
+    $$ = parser->m_arena->create<Timespan>();
     $$->begin = $$->end = $T;
     $$->pointInTime = true;
     $$->openEnd = true;
   }
 | Time[T1] RangeSeparator Time[T2] {
-    $$ = new Timespan;
+    $$ = parser->m_arena->create<Timespan>();
     $$->begin = $T1;
     $$->end = $T2;
   }
 | Time[T1] RangeSeparator Time[T2] T_PLUS {
-    $$ = new Timespan;
+    $$ = parser->m_arena->create<Timespan>();
     $$->begin = $T1;
     $$->end = $T2;
     $$->openEnd = true;
   }
 | Time[T1] RangeSeparator Time[T2] T_SLASH T_INTEGER[I] {
-    $$ = new Timespan;
+    $$ = parser->m_arena->create<Timespan>();
     $$->begin = $T1;
     $$->end = $T2;
     $$->interval = $I;
   }
 | Time[T1] RangeSeparator Time[T2] T_SLASH ExtendedHourMinute[I] {
-    $$ = new Timespan;
+    $$ = parser->m_arena->create<Timespan>();
     $$->begin = $T1;
     $$->end = $T2;
     $$->interval = $I.hour * 60 + $I.minute;
@@ -459,14 +446,14 @@ HolidayAndWeekdaySequence:
 
 HolidayAndWeekday:
   HolidaySequence[H] WeekdaySequence[W] {
-    $$ = new WeekdayRange;
-    $$->lhsAndSelector.reset($H);
-    $$->rhsAndSelector.reset($W);
+    $$ = parser->m_arena->create<WeekdayRange>();
+    $$->lhsAndSelector = $H;
+    $$->rhsAndSelector = $W;
   }
 | WeekdaySequence[W] HolidaySequence[H] { // wrong order according to the specification
-    $$ = new WeekdayRange;
-    $$->lhsAndSelector.reset($H);
-    $$->rhsAndSelector.reset($W);
+    $$ = parser->m_arena->create<WeekdayRange>();
+    $$->lhsAndSelector = $H;
+    $$->rhsAndSelector = $W;
   }
 ;
 
@@ -493,24 +480,24 @@ WeekdaySequence:
 
 WeekdayRange:
   T_WEEKDAY[D] {
-    $$ = new WeekdayRange;
+    $$ = parser->m_arena->create<WeekdayRange>();
     $$->beginDay = $D;
     $$->endDay = $D;
   }
 | T_WEEKDAY[D1] RangeSeparator T_WEEKDAY[D2] {
-    $$ = new WeekdayRange;
+    $$ = parser->m_arena->create<WeekdayRange>();
     $$->beginDay = $D1;
     $$->endDay = $D2;
   }
 | T_WEEKDAY[D] T_LBRACKET NthSequence[N] T_RBRACKET {
-    $$ = new WeekdayRange;
+    $$ = parser->m_arena->create<WeekdayRange>();
     $$->beginDay = $$->endDay = $D;
-    $$->nthSequence.reset($N);
+    $$->nthSequence = $N;
   }
 | T_WEEKDAY[D] T_LBRACKET NthSequence[N] T_RBRACKET DayOffset[O] {
-    $$ = new WeekdayRange;
+    $$ = parser->m_arena->create<WeekdayRange>();
     $$->beginDay = $$->endDay = $D;
-    $$->nthSequence.reset($N);
+    $$->nthSequence = $N;
     $$->offset = $O;
   }
 ;
@@ -522,23 +509,23 @@ HolidaySequence:
 
 Holiday:
   T_PH {
-    $$ = new WeekdayRange;
+    $$ = parser->m_arena->create<WeekdayRange>();
     $$->holiday = WeekdayRange::PublicHoliday;
   }
 | T_PH DayOffset[O] {
-    $$ = new WeekdayRange;
+    $$ = parser->m_arena->create<WeekdayRange>();
     $$->holiday = WeekdayRange::PublicHoliday;
     $$->offset = $O;
   }
 | T_SH {
-    $$ = new WeekdayRange;
+    $$ = parser->m_arena->create<WeekdayRange>();
     $$->holiday = WeekdayRange::SchoolHoliday;
   }
 ;
 
 NthSequence:
   NthEntry[N] {
-      $$ = new NthSequence;
+      $$ = parser->m_arena->create<NthSequence>();
       $$->add($N);
   }
 | NthSequence[N1] T_COMMA NthEntry[N2] {
@@ -580,16 +567,16 @@ WeekSelector:
 
 Week:
   T_INTEGER[N] {
-    $$ = new Week;
+    $$ = parser->m_arena->create<Week>();
     $$->beginWeek = $$->endWeek = $N;
   }
 | T_INTEGER[N1] T_MINUS T_INTEGER[N2] {
-    $$ = new Week;
+    $$ = parser->m_arena->create<Week>();
     $$->beginWeek = $N1;
     $$->endWeek = $N2;
   }
 | T_INTEGER[N1] T_MINUS T_INTEGER[N2] T_SLASH T_INTEGER[I] {
-    $$ = new Week;
+    $$ = parser->m_arena->create<Week>();
     $$->beginWeek = $N1;
     $$->endWeek = $N2;
     $$->interval = $I;
@@ -612,32 +599,28 @@ MonthdaySelector:
     // month day sets, not covered the official grammar but in the
     // description in https://wiki.openstreetmap.org/wiki/Key:opening_hours#Summary_syntax
     $$ = $S;
-    if (!extendMonthdaySelector($$.monthdaySelector, $D, $D)) {
-        delete $$.monthdaySelector;
+    if (!extendMonthdaySelector(parser, $$.monthdaySelector, $D, $D)) {
         YYABORT;
     }
   }
 | MonthdaySelector[S] T_ADDITIONAL_RULE_SEPARATOR T_INTEGER[D] {
     // same as the above, just with the wrong ", " separator
     $$ = $S;
-    if (!extendMonthdaySelector($$.monthdaySelector, $D, $D)) {
-        delete $$.monthdaySelector;
+    if (!extendMonthdaySelector(parser, $$.monthdaySelector, $D, $D)) {
         YYABORT;
     }
   }
 | MonthdaySelector[S] T_COMMA T_INTEGER[D1] T_MINUS T_INTEGER[D2] {
     // same with a range of days
     $$ = $S;
-    if (!extendMonthdaySelector($$.monthdaySelector, $D1, $D2)) {
-        delete $$.monthdaySelector;
+    if (!extendMonthdaySelector(parser, $$.monthdaySelector, $D1, $D2)) {
         YYABORT;
     }
   }
 | MonthdaySelector[S] T_ADDITIONAL_RULE_SEPARATOR T_INTEGER[D1] T_MINUS T_INTEGER[D2] {
     // same as the above, just with the wrong ", " separator
     $$ = $S;
-    if (!extendMonthdaySelector($$.monthdaySelector, $D1, $D2)) {
-        delete $$.monthdaySelector;
+    if (!extendMonthdaySelector(parser, $$.monthdaySelector, $D1, $D2)) {
         YYABORT;
     }
   }
@@ -645,59 +628,59 @@ MonthdaySelector:
 
 MonthdayRange:
   T_YEAR[Y] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = $$->end = { $Y, 0, 0, Date::FixedDate, { 0, 0, 0 } };
   }
 | MonthdayRangeAdditional[M] { $$ = $M; }
 
 MonthdayRangeAdditional:
   T_MONTH[M] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = $$->end = { 0, $M, 0, Date::FixedDate, { 0, 0, 0 } };
   }
 | T_YEAR[Y] T_MONTH[M] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = $$->end = { $Y, $M, 0, Date::FixedDate, { 0, 0, 0 } };
   }
 | T_MONTH[M1] RangeSeparator T_MONTH[M2] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = { 0, $M1, 0, Date::FixedDate, { 0, 0, 0 } };
     $$->end = { 0, $M2, 0, Date::FixedDate, { 0, 0, 0 } };
   }
 | T_YEAR[Y] T_MONTH[M1] RangeSeparator T_MONTH[M2] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = { $Y, $M1, 0, Date::FixedDate, { 0, 0, 0 } };
     $$->end = { $Y, $M2, 0, Date::FixedDate, { 0, 0, 0 } };
   }
 | T_YEAR[Y1] T_MONTH[M1] RangeSeparator T_YEAR[Y2] T_MONTH[M2] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = { $Y1, $M1, 0, Date::FixedDate, { 0, 0, 0 } };
     $$->end = { $Y2, $M2, 0, Date::FixedDate, { 0, 0, 0 } };
   }
 | T_MONTH[M1] AltMonthdayOffset[O1] RangeSeparator T_MONTH[M2] AltMonthdayOffset[O2] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = { 0, $M1, 0, Date::FixedDate, $O1 };
     $$->end = { 0, $M2, 0, Date::FixedDate, $O2 };
   }
 | DateFrom[D] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = $$->end = $D;
   }
 | DateFrom[D] DateOffset[O] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = $D;
     $$->begin.offset += $O;
     $$->end = $$->begin;
   }
 | DateFrom[F] RangeSeparator DateTo[T] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = $F;
     $$->end = $T;
     if ($$->end.year == 0) { $$->end.year = $$->begin.year; }
     if ($$->end.month == 0) { $$->end.month = $$->begin.month; }
   }
 | DateFrom[F] DateOffset[OF] RangeSeparator DateTo[T] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = $F;
     $$->begin.offset += $OF;
     $$->end = $T;
@@ -705,7 +688,7 @@ MonthdayRangeAdditional:
     if ($$->end.month == 0) { $$->end.month = $$->begin.month; }
   }
 | DateFrom[F] RangeSeparator DateTo[T] DateOffset[OT] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = $F;
     $$->end = $T;
     if ($$->end.year == 0) { $$->end.year = $$->begin.year; }
@@ -713,17 +696,17 @@ MonthdayRangeAdditional:
     $$->end.offset += $OT;
   }
 | DateFrom[F] RangeSeparator T_MONTH[M] AltMonthdayOffset[O] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = $F;
     $$->end = { $F.year, $M, 0, Date::FixedDate, $O };
   }
 | T_MONTH[M] AltMonthdayOffset[O] RangeSeparator DateTo[T] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = { 0, $M, 0, Date::FixedDate, $O };
     $$->end = $T;
   }
 | DateFrom[F] DateOffset[OF] RangeSeparator DateTo[T] DateOffset[OT] {
-    $$ = new MonthdayRange;
+    $$ = parser->m_arena->create<MonthdayRange>();
     $$->begin = $F;
     $$->begin.offset += $OF;
     $$->end = $T;
@@ -791,7 +774,7 @@ YearSelectorCombined:
 
 YearRange:
   T_YEAR[Y] {
-    $$ = new YearRange;
+    $$ = parser->m_arena->create<YearRange>();
     $$->begin = $$->end = $Y;
   }
 | YearRangeStandalone[Y] { $$ = $Y; }
@@ -799,31 +782,29 @@ YearRange:
 
 YearRangeStandalone:
   T_YEAR[Y1] RangeSeparator T_YEAR[Y2] {
-    $$ = new YearRange;
+    $$ = parser->m_arena->create<YearRange>();
     $$->begin = $Y1;
     $$->end = $Y2;
     if ($$->end < $$->begin) {
-        delete $$;
         YYABORT;
     }
   }
 | T_YEAR[Y] T_SLASH T_INTEGER[I] {
-    $$ = new YearRange;
+    $$ = parser->m_arena->create<YearRange>();
     $$->begin = $Y;
     $$->interval = $I;
   }
 | T_YEAR[Y1] RangeSeparator T_YEAR[Y2] T_SLASH T_INTEGER[I] {
-    $$ = new YearRange;
+    $$ = parser->m_arena->create<YearRange>();
     $$->begin = $Y1;
     $$->end = $Y2;
     if ($$->end < $$->begin) {
-        delete $$;
         YYABORT;
     }
     $$->interval = $I;
   }
 | T_YEAR[Y] T_PLUS {
-    $$ = new YearRange;
+    $$ = parser->m_arena->create<YearRange>();
     $$->begin = $Y;
   }
 
@@ -8,7 +8,6 @@
 #include "logging.h"
 #include "openinghours_p.h"
 
-
 using namespace KOpeningHours;
 
 Interval::State Rule::state() const
@@ -7,12 +7,9 @@
 #ifndef KOPENINGHOURS_RULE_P_H
 #define KOPENINGHOURS_RULE_P_H
 
-#include "interval.h"
+#include "localinterval_p.h"
 #include "selectors_p.h"
 
-
-#include <memory>
-
 namespace KOpeningHours {
 
 enum class State { // must be in the same order as Interval::State
@@ -27,7 +24,7 @@ enum class State { // must be in the same order as Interval::State
 class RuleResult
 {
 public:
-    Interval interval;
+    LocalInterval interval;
     enum Mode {
         Override,
         Merge,
@@ -62,20 +59,26 @@ public:
     bool hasSmallRangeSelector() const;
     bool hasWideRangeSelector() const;
 
-    RuleResult nextInterval(const QDateTime &dt, OpeningHoursPrivate *context) const;
+    RuleResult nextInterval(LocalDateTime dt, OpeningHoursPrivate *context) const;
+    /** First day on which this rule cannot match anymore, due to its year or fixed-year date selectors.
+     *  Invalid if this rule can match arbitrarily far in the future.
+     */
+    QDate endDate() const;
     QByteArray toExpression() const;
 
     /** Amount of selectors for this rule. */
     int selectorCount() const;
 
     QString m_comment;
+    quint32 m_commentId = 0; // index of m_comment in OpeningHoursPrivate::m_comments
     QString m_wideRangeSelectorComment;
 
-    std::unique_ptr<Timespan> m_timeSelector;
-    std::unique_ptr<WeekdayRange> m_weekdaySelector;
-    std::unique_ptr<Week> m_weekSelector;
-    std::unique_ptr<MonthdayRange> m_monthdaySelector;
-    std::unique_ptr<YearRange> m_yearSelector;
+    // selectors are owned by the AstArena of the expression
+    Timespan *m_timeSelector = nullptr;
+    WeekdayRange *m_weekdaySelector = nullptr;
+    Week *m_weekSelector = nullptr;
+    MonthdayRange *m_monthdaySelector = nullptr;
+    YearRange *m_yearSelector = nullptr;
     bool m_seen_24_7 = false;
     bool m_colonAfterWideRangeSelector = false;
 
@@ -86,7 +89,9 @@ private:
     Interval::State m_state = Interval::Invalid;
 
     enum { RecursionLimit = 64 };
-    RuleResult nextInterval(const QDateTime &dt, OpeningHoursPrivate *context, int recursionBudget) const;
+    /** Maximum amount of candidate days considered when searching for a day matching all date selectors. */
+    enum { CandidateDayLimit = 256 };
+    RuleResult nextInterval(LocalDateTime dt, OpeningHoursPrivate *context, int recursionBudget) const;
 };
 
 }
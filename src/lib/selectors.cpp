@@ -13,6 +13,13 @@
 
 using namespace KOpeningHours;
 
+/** Compares two optional selectors, including the selectors chained to them. */
+template <typename T>
+static bool equalSelectors(const T *lhs, const T *rhs)
+{
+    return lhs == rhs || (lhs && rhs && *lhs == *rhs);
+}
+
 static QByteArray twoDigits(int n)
 {
     QByteArray ret = QByteArray::number(n);
@@ -140,14 +147,14 @@ Time Timespan::adjustedEnd() const
     return end;
 }
 
-bool Timespan::operator==(Timespan &other) const
+bool Timespan::operator==(const Timespan &other) const
 {
     return begin == other.begin &&
             end == other.end &&
             openEnd == other.openEnd &&
+            pointInTime == other.pointInTime &&
             interval == other.interval &&
-            bool(next) == (bool)other.next &&
-            (!next || *next == *other.next);
+            equalSelectors(next, other.next);
 }
 
 int WeekdayRange::requiredCapabilities() const
@@ -215,13 +222,25 @@ QByteArray WeekdayRange::toExpression() const
     return expr;
 }
 
-void WeekdayRange::simplify()
+bool WeekdayRange::operator==(const WeekdayRange &other) const
+{
+    return beginDay == other.beginDay &&
+            endDay == other.endDay &&
+            offset == other.offset &&
+            holiday == other.holiday &&
+            equalSelectors(nthSequence, other.nthSequence) &&
+            equalSelectors(lhsAndSelector, other.lhsAndSelector) &&
+            equalSelectors(rhsAndSelector, other.rhsAndSelector) &&
+            equalSelectors(next, other.next);
+}
+
+void WeekdayRange::simplify(AstArena &arena)
 {
     QMap<int, WeekdayRange *> endToSelectorMap;
     bool seenDays[8];
     const int endIdx = sizeof(seenDays);
     std::fill(std::begin(seenDays), std::end(seenDays), false);
-    for (WeekdayRange *selector = this; selector; selector = selector->next.get()) {
+    for (WeekdayRange *selector = this; selector; selector = selector->next) {
         // Ensure it's all just week days, no other features
         if (selector->nthSequence || selector->lhsAndSelector || selector->holiday != NoHoliday || selector->offset) {
             return;
@@ -239,7 +258,7 @@ void WeekdayRange::simplify()
     }
 
     // Clear everything and refill
-    next.reset(nullptr);
+    next = nullptr;
 
     int startIdx = 1;
 
@@ -275,8 +294,8 @@ void WeekdayRange::simplify()
 
     auto addRange = [&](int from, int to) {
         if (prev) {
-            selector = new WeekdayRange;
-            prev->next.reset(selector);
+            selector = arena.create<WeekdayRange>();
+            prev->next = selector;
         }
         selector->beginDay = from;
         selector->endDay = to;
@@ -321,6 +340,11 @@ int Week::requiredCapabilities() const
     return next ? next->requiredCapabilities() : Capability::None;
 }
 
+bool Week::operator==(const Week &other) const
+{
+    return beginWeek == other.beginWeek && endWeek == other.endWeek && interval == other.interval && equalSelectors(next, other.next);
+}
+
 QByteArray Week::toExpression() const
 {
     QByteArray expr = twoDigits(beginWeek);
@@ -423,6 +447,11 @@ bool Date::hasOffset() const
     return offset.dayOffset || offset.weekday;
 }
 
+bool MonthdayRange::operator==(const MonthdayRange &other) const
+{
+    return begin == other.begin && end == other.end && equalSelectors(next, other.next);
+}
+
 int MonthdayRange::requiredCapabilities() const
 {
     return Capability::None;
@@ -463,6 +492,11 @@ int YearRange::requiredCapabilities() const
     return Capability::None;
 }
 
+bool YearRange::operator==(const YearRange &other) const
+{
+    return begin == other.begin && end == other.end && interval == other.interval && equalSelectors(next, other.next);
+}
+
 QByteArray YearRange::toExpression() const
 {
     QByteArray expr = QByteArray::number(begin);
@@ -7,12 +7,13 @@
 #ifndef KOPENINGHOURS_SELECTORS_P_H
 #define KOPENINGHOURS_SELECTORS_P_H
 
-#include "interval.h"
+#include "localinterval_p.h"
 
-#include <memory>
+#include <vector>
 
 namespace KOpeningHours {
 
+class AstArena;
 class OpeningHoursPrivate;
 
 namespace Capability {
@@ -38,7 +39,7 @@ public:
         , m_matching(offset >= 0)
         {}
     /** Selector matches for @p interval. */
-    inline SelectorResult(const Interval &interval) : m_interval(interval) {}
+    inline SelectorResult(const LocalInterval &interval) : m_interval(interval) {}
 
     inline bool operator<(const SelectorResult &other) const {
         if (m_matching == other.m_matching) {
@@ -52,10 +53,10 @@ public:
 
     inline bool canMatch() const { return m_matching; }
     inline int64_t matchOffset() const { return m_offset; }
-    inline Interval interval() const { return m_interval; }
+    inline const LocalInterval& interval() const { return m_interval; }
 
 private:
-    Interval m_interval;
+    LocalInterval m_interval;
     int64_t m_offset = 0;
     bool m_matching = true;
 };
@@ -63,25 +64,19 @@ private:
 // see https://wiki.openstreetmap.org/wiki/Key:opening_hours/specification, the below names/types follow that
 
 template <typename T>
-void appendSelector(T* firstSelector, std::unique_ptr<T> &&selector)
+void appendSelector(T* firstSelector, T* selector)
 {
     while(firstSelector->next) {
-        firstSelector = firstSelector->next.get();
+        firstSelector = firstSelector->next;
     }
-    firstSelector->next = std::move(selector);
-}
-
-template <typename T>
-void appendSelector(T* firstSelector, T* selector)
-{
-    return appendSelector(firstSelector, std::unique_ptr<T>(selector));
+    firstSelector->next = selector;
 }
 
 template <typename T>
 T* lastSelector(T* firstSelector)
 {
     while (firstSelector && firstSelector->next) {
-        firstSelector = firstSelector->next.get();
+        firstSelector = firstSelector->next;
     }
     return firstSelector;
 }
@@ -115,6 +110,10 @@ inline constexpr bool operator==(Time lhs, Time rhs)
         && lhs.hour == rhs.hour
         && lhs.minute == rhs.minute;
 }
+inline constexpr bool operator!=(Time lhs, Time rhs)
+{
+    return !(lhs == rhs);
+}
 
 /** Time span selector. */
 class Timespan
@@ -122,23 +121,26 @@ class Timespan
 public:
     int requiredCapabilities() const;
     bool isMultiDay(QDate date, OpeningHoursPrivate *context) const;
-    SelectorResult nextInterval(const Interval &interval, const QDateTime &dt, OpeningHoursPrivate *context) const;
+    SelectorResult nextInterval(const LocalInterval &interval, LocalDateTime dt, OpeningHoursPrivate *context) const;
     QByteArray toExpression() const;
     Time adjustedEnd() const;
-    bool operator==(Timespan &other) const;
+    /** Structural comparison, including all following selectors. */
+    bool operator==(const Timespan &other) const;
+    inline bool operator!=(const Timespan &other) const { return !operator==(other); }
 
     Time begin = { Time::NoEvent, -1, -1 };
     Time end = { Time::NoEvent, -1, -1 };
     int interval = 0;
     bool openEnd = false;
     bool pointInTime = false;
-    std::unique_ptr<Timespan> next;
+    Timespan *next = nullptr;
 };
 
 struct NthEntry {
     int begin;
     int end;
     QByteArray toExpression() const;
+    inline bool operator==(NthEntry other) const { return begin == other.begin && end == other.end; }
 };
 
 /** Nth week days, like 1-2,4,6-8 */
@@ -147,6 +149,7 @@ class NthSequence
 public:
     void add(NthEntry range);
     QByteArray toExpression() const;
+    inline bool operator==(const NthSequence &other) const { return sequence == other.sequence; }
     std::vector<NthEntry> sequence;
 };
 
@@ -155,14 +158,17 @@ class WeekdayRange
 {
 public:
     int requiredCapabilities() const;
-    SelectorResult nextInterval(const Interval &interval, const QDateTime &dt, OpeningHoursPrivate *context) const;
-    SelectorResult nextIntervalLocal(const Interval &interval, const QDateTime &dt, OpeningHoursPrivate *context) const;
+    SelectorResult nextInterval(const LocalInterval &interval, LocalDateTime dt, OpeningHoursPrivate *context) const;
+    SelectorResult nextIntervalLocal(const LocalInterval &interval, LocalDateTime dt, OpeningHoursPrivate *context) const;
     QByteArray toExpression() const;
-    void simplify();
+    void simplify(AstArena &arena);
+    /** Structural comparison, including all following and combined selectors. */
+    bool operator==(const WeekdayRange &other) const;
+    inline bool operator!=(const WeekdayRange &other) const { return !operator==(other); }
 
     uint8_t beginDay = 0; // Mo=1, Tu=2, ..., Su=7
     uint8_t endDay = 0;
-    std::unique_ptr<NthSequence> nthSequence;
+    NthSequence *nthSequence = nullptr;
     int16_t offset = 0;
     enum Holiday : uint8_t {
         NoHoliday = 0,
@@ -170,9 +176,9 @@ public:
         SchoolHoliday = 2,
     };
     Holiday holiday = NoHoliday;
-    std::unique_ptr<WeekdayRange> next;
-    std::unique_ptr<WeekdayRange> lhsAndSelector;
-    std::unique_ptr<WeekdayRange> rhsAndSelector;
+    WeekdayRange *next = nullptr;
+    WeekdayRange *lhsAndSelector = nullptr;
+    WeekdayRange *rhsAndSelector = nullptr;
 };
 
 /** Week */
@@ -180,13 +186,15 @@ class Week
 {
 public:
     int requiredCapabilities() const;
-    SelectorResult nextInterval(const Interval &interval, const QDateTime &dt, OpeningHoursPrivate *context) const;
+    SelectorResult nextInterval(const LocalInterval &interval, LocalDateTime dt, OpeningHoursPrivate *context) const;
     QByteArray toExpression() const;
+    bool operator==(const Week &other) const;
+    inline bool operator!=(const Week &other) const { return !operator==(other); }
 
     uint8_t beginWeek = 0;
     uint8_t endWeek = 0;
     uint8_t interval = 1;
-    std::unique_ptr<Week> next;
+    Week *next = nullptr;
 };
 
 /** Day or weekday-based offset to a Date. */
@@ -228,13 +236,15 @@ class MonthdayRange
 {
 public:
     int requiredCapabilities() const;
-    SelectorResult nextInterval(const Interval &interval, const QDateTime &dt, OpeningHoursPrivate *context) const;
+    SelectorResult nextInterval(const LocalInterval &interval, LocalDateTime dt, OpeningHoursPrivate *context) const;
     QByteArray toExpression(const MonthdayRange &prev) const;
     void simplify();
+    bool operator==(const MonthdayRange &other) const;
+    inline bool operator!=(const MonthdayRange &other) const { return !operator==(other); }
 
     Date begin = { 0, 0, 0, Date::FixedDate, { 0, 0, 0 } };
     Date end = { 0, 0, 0, Date::FixedDate, { 0, 0, 0 } };
-    std::unique_ptr<MonthdayRange> next;
+    MonthdayRange *next = nullptr;
 };
 
 /** Year range. */
@@ -242,14 +252,17 @@ class YearRange
 {
 public:
     int requiredCapabilities() const;
-    SelectorResult nextInterval(const Interval &interval, const QDateTime &dt, OpeningHoursPrivate *context) const;
+    SelectorResult nextInterval(const LocalInterval &interval, LocalDateTime dt, OpeningHoursPrivate *context) const;
     QByteArray toExpression() const;
+    bool operator==(const YearRange &other) const;
+    inline bool operator!=(const YearRange &other) const { return !operator==(other); }
 
     int begin = 0;
     int end = 0;
     int interval = 1;
-    std::unique_ptr<YearRange> next;
+    YearRange *next = nullptr;
 };
+
 }
 
 #endif // KOPENINGHOURS_SELECTORS_P_H
@@ -0,0 +1,325 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "openinghours.h"
+#include "openinghours_p.h"
+#include "logging.h"
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+#include "holidaycache_p.h"
+#endif
+
+#include <QDataStream>
+
+using namespace KOpeningHours;
+
+// serialization format, all data is in QDataStream encoding:
+// magic, format version, modes, syntax error flag, latitude, longitude, region, time zone id, number of rules,
+// followed by the rules. Selector lists are written as element count followed by the elements, the
+// weekday selector tree in pre-order with a presence flag per node. Nothing refers to memory addresses,
+// so serialized data can be used from anywhere, including memory-mapped files.
+static constexpr quint32 SerializationMagic = 0x4b4f4845; // "KOHE"
+static constexpr quint32 SerializationFormatVersion = 1;
+static constexpr auto SerializationStreamVersion = QDataStream::Qt_5_12;
+
+// bounds for data read from untrusted input
+enum { MaxSelectorCount = 1024, MaxWeekdayDepth = 64 };
+
+namespace {
+template <typename T>
+quint32 listSize(const T *selector)
+{
+    quint32 count = 0;
+    for (; selector; selector = selector->next) {
+        ++count;
+    }
+    return count;
+}
+
+template <typename T, typename F>
+void writeList(QDataStream &stream, const T *selector, F &&writeElement)
+{
+    stream << listSize(selector);
+    for (; selector; selector = selector->next) {
+        writeElement(stream, *selector);
+    }
+}
+
+template <typename T, typename F>
+bool readList(QDataStream &stream, AstArena &arena, T *&selector, F &&readElement)
+{
+    quint32 count = 0;
+    stream >> count;
+    if (stream.status() != QDataStream::Ok || count > MaxSelectorCount) {
+        return false;
+    }
+    T **tail = &selector;
+    for (quint32 i = 0; i < count; ++i) {
+        *tail = arena.create<T>();
+        readElement(stream, **tail);
+        if (stream.status() != QDataStream::Ok) {
+            return false;
+        }
+        tail = &(*tail)->next;
+    }
+    return true;
+}
+
+void writeTime(QDataStream &stream, Time t)
+{
+    stream << static_cast<qint8>(t.event) << static_cast<qint16>(t.hour) << static_cast<qint16>(t.minute);
+}
+
+void readTime(QDataStream &stream, Time &t)
+{
+    qint8 event = 0;
+    qint16 hour = 0, minute = 0;
+    stream >> event >> hour >> minute;
+    if (event < Time::NoEvent || event > Time::Dusk) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+    }
+    t = { static_cast<Time::Event>(event), hour, minute };
+}
+
+void writeDate(QDataStream &stream, const Date &date)
+{
+    stream << static_cast<qint32>(date.year) << static_cast<qint8>(date.month) << static_cast<qint8>(date.day)
+           << static_cast<quint8>(date.variableDate)
+           << date.offset.dayOffset << date.offset.weekday << date.offset.nthWeekday;
+}
+
+void readDate(QDataStream &stream, Date &date)
+{
+    qint32 year = 0;
+    qint8 month = 0, day = 0;
+    quint8 variableDate = 0;
+    stream >> year >> month >> day >> variableDate >> date.offset.dayOffset >> date.offset.weekday >> date.offset.nthWeekday;
+    // month and weekday are used as array indexes when turning this back into an expression
+    if (variableDate > Date::Easter || month < 0 || month > 12 || day < 0 || day > 31
+        || date.offset.weekday < 0 || date.offset.weekday > 7 || (date.offset.nthWeekday != 0 && date.offset.weekday == 0)
+        || date.offset.nthWeekday < -5 || date.offset.nthWeekday > 5) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+    }
+    date.year = year;
+    date.month = month;
+    date.day = day;
+    date.variableDate = static_cast<Date::VariableDate>(variableDate);
+}
+
+void writeWeekdayRange(QDataStream &stream, const WeekdayRange *selector)
+{
+    stream << static_cast<quint8>(selector != nullptr);
+    if (!selector) {
+        return;
+    }
+    stream << selector->beginDay << selector->endDay << selector->offset << static_cast<quint8>(selector->holiday);
+    if (selector->nthSequence) {
+        stream << static_cast<quint32>(selector->nthSequence->sequence.size());
+        for (const auto &entry : selector->nthSequence->sequence) {
+            stream << static_cast<qint8>(entry.begin) << static_cast<qint8>(entry.end);
+        }
+    } else {
+        stream << quint32(0);
+    }
+    writeWeekdayRange(stream, selector->lhsAndSelector);
+    writeWeekdayRange(stream, selector->rhsAndSelector);
+    writeWeekdayRange(stream, selector->next);
+}
+
+bool readWeekdayRange(QDataStream &stream, AstArena &arena, WeekdayRange *&selector, int depth)
+{
+    quint8 present = 0;
+    stream >> present;
+    if (stream.status() != QDataStream::Ok || depth > MaxWeekdayDepth) {
+        return false;
+    }
+    if (!present) {
+        return true;
+    }
+
+    selector = arena.create<WeekdayRange>();
+    quint8 holiday = 0;
+    quint32 nthCount = 0;
+    stream >> selector->beginDay >> selector->endDay >> selector->offset >> holiday >> nthCount;
+    if (stream.status() != QDataStream::Ok || holiday > WeekdayRange::SchoolHoliday || nthCount > MaxSelectorCount
+        || selector->beginDay > 7 || selector->endDay > 7 || (selector->beginDay == 0) != (selector->endDay == 0)) {
+        return false;
+    }
+    selector->holiday = static_cast<WeekdayRange::Holiday>(holiday);
+    if (nthCount > 0) {
+        selector->nthSequence = arena.create<NthSequence>();
+        selector->nthSequence->sequence.reserve(nthCount);
+        for (quint32 i = 0; i < nthCount; ++i) {
+            qint8 begin = 0, end = 0;
+            stream >> begin >> end;
+            // same constraints as in the parser
+            const auto validEntry = (begin >= 1 && end <= 5 && begin <= end) || (begin >= -5 && begin == end && begin <= -1);
+            if (stream.status() != QDataStream::Ok || !validEntry) {
+                return false;
+            }
+            selector->nthSequence->sequence.push_back({ begin, end });
+        }
+    }
+    if (!readWeekdayRange(stream, arena, selector->lhsAndSelector, depth + 1) || !readWeekdayRange(stream, arena, selector->rhsAndSelector, depth + 1)) {
+        return false;
+    }
+    // only holiday and combined selectors have no days, everything else indexes the weekday names with them
+    if (selector->beginDay == 0 && selector->holiday == WeekdayRange::NoHoliday && !(selector->lhsAndSelector && selector->rhsAndSelector)) {
+        return false;
+    }
+    return readWeekdayRange(stream, arena, selector->next, depth + 1);
+}
+
+void writeRule(QDataStream &stream, const Rule &rule)
+{
+    stream << rule.m_comment << rule.m_wideRangeSelectorComment
+           << static_cast<quint8>(rule.hasImplicitState() ? Interval::Invalid : rule.state())
+           << static_cast<quint8>(rule.m_stateFlags) << static_cast<quint8>(rule.m_ruleType)
+           << rule.m_seen_24_7 << rule.m_colonAfterWideRangeSelector;
+
+    writeList(stream, rule.m_timeSelector, [](QDataStream &stream, const Timespan &t) {
+        writeTime(stream, t.begin);
+        writeTime(stream, t.end);
+        stream << static_cast<qint32>(t.interval) << t.openEnd << t.pointInTime;
+    });
+    writeWeekdayRange(stream, rule.m_weekdaySelector);
+    writeList(stream, rule.m_weekSelector, [](QDataStream &stream, const Week &w) {
+        stream << w.beginWeek << w.endWeek << w.interval;
+    });
+    writeList(stream, rule.m_monthdaySelector, [](QDataStream &stream, const MonthdayRange &m) {
+        writeDate(stream, m.begin);
+        writeDate(stream, m.end);
+    });
+    writeList(stream, rule.m_yearSelector, [](QDataStream &stream, const YearRange &y) {
+        stream << static_cast<qint32>(y.begin) << static_cast<qint32>(y.end) << static_cast<qint32>(y.interval);
+    });
+}
+
+bool readRule(QDataStream &stream, AstArena &arena, Rule &rule)
+{
+    quint8 state = 0, stateFlags = 0, ruleType = 0;
+    stream >> rule.m_comment >> rule.m_wideRangeSelectorComment >> state >> stateFlags >> ruleType
+           >> rule.m_seen_24_7 >> rule.m_colonAfterWideRangeSelector;
+    if (stream.status() != QDataStream::Ok || state > Interval::Unknown || stateFlags > Rule::Off || ruleType >= Rule::GuessRuleType) {
+        return false;
+    }
+    if (state != Interval::Invalid) {
+        rule.setState(static_cast<State>(state));
+    }
+    rule.m_stateFlags = static_cast<Rule::StateFlags>(stateFlags);
+    rule.m_ruleType = static_cast<Rule::Type>(ruleType);
+
+    return readList(stream, arena, rule.m_timeSelector, [](QDataStream &stream, Timespan &t) {
+            qint32 interval = 0;
+            readTime(stream, t.begin);
+            readTime(stream, t.end);
+            stream >> interval >> t.openEnd >> t.pointInTime;
+            t.interval = interval;
+        })
+        && readWeekdayRange(stream, arena, rule.m_weekdaySelector, 0)
+        && readList(stream, arena, rule.m_weekSelector, [](QDataStream &stream, Week &w) {
+            stream >> w.beginWeek >> w.endWeek >> w.interval;
+        })
+        && readList(stream, arena, rule.m_monthdaySelector, [](QDataStream &stream, MonthdayRange &m) {
+            readDate(stream, m.begin);
+            readDate(stream, m.end);
+        })
+        && readList(stream, arena, rule.m_yearSelector, [](QDataStream &stream, YearRange &y) {
+            qint32 begin = 0, end = 0, interval = 0;
+            stream >> begin >> end >> interval;
+            y.begin = begin;
+            y.end = end;
+            y.interval = interval;
+        });
+}
+}
+
+QByteArray OpeningHours::serialize() const
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(SerializationStreamVersion);
+
+    stream << SerializationMagic << SerializationFormatVersion << static_cast<quint8>(d->m_modes)
+           << (d->m_error == SyntaxError) << d->m_latitude << d->m_longitude;
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+    stream << d->m_region.regionCode();
+#else
+    stream << QString();
+#endif
+    stream << d->m_timezone.id();
+
+    stream << static_cast<quint32>(d->m_rules.size());
+    for (const auto rule : d->m_rules) {
+        writeRule(stream, *rule);
+    }
+    return data;
+}
+
+bool OpeningHours::deserialize(const QByteArray &data)
+{
+    return deserialize(data.constData(), data.size());
+}
+
+bool OpeningHours::deserialize(const char *data, std::size_t size)
+{
+    detach();
+    d->m_error = OpeningHours::Null;
+    d->m_parseStatistics = {};
+    d->m_rules.clear();
+    if (d->m_arena.use_count() > 1) {
+        d->m_arena = std::make_shared<AstArena>();
+    } else {
+        d->m_arena->clear();
+    }
+
+    QDataStream stream(QByteArray::fromRawData(data, static_cast<int>(size)));
+    stream.setVersion(SerializationStreamVersion);
+
+    quint32 magic = 0, formatVersion = 0;
+    stream >> magic >> formatVersion;
+    if (magic != SerializationMagic || formatVersion != SerializationFormatVersion) {
+        qCWarning(Log) << "Invalid or incompatible serialized expression" << magic << formatVersion;
+        d->validate();
+        return false;
+    }
+
+    quint8 modes = 0;
+    bool syntaxError = false;
+    QString region;
+    QByteArray timezone;
+    quint32 ruleCount = 0;
+    stream >> modes >> syntaxError >> d->m_latitude >> d->m_longitude >> region >> timezone >> ruleCount;
+    if (stream.status() != QDataStream::Ok || ruleCount > MaxSelectorCount) {
+        qCWarning(Log) << "Corrupt serialized expression";
+        d->m_rules.clear();
+        d->validate();
+        return false;
+    }
+
+    d->m_rules.reserve(ruleCount);
+    for (quint32 i = 0; i < ruleCount; ++i) {
+        auto rule = d->m_arena->create<Rule>();
+        if (!readRule(stream, *d->m_arena, *rule)) {
+            qCWarning(Log) << "Corrupt serialized expression";
+            d->m_rules.clear();
+            d->validate();
+            return false;
+        }
+        d->m_rules.push_back(rule);
+    }
+
+    d->m_modes = OpeningHours::Modes(modes);
+#ifndef KOPENINGHOURS_VALIDATOR_ONLY
+    d->m_region = region.isEmpty() ? KHolidays::HolidayRegion() : HolidayCache::resolveRegion(region);
+#else
+    Q_UNUSED(region)
+#endif
+    d->m_timezone = timezone.isEmpty() ? QTimeZone::systemTimeZone() : QTimeZone(timezone);
+    d->m_error = syntaxError ? SyntaxError : NoError;
+    d->assignCommentIds();
+    d->validate();
+    return true;
+}
@@ -0,0 +1,153 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_SLOTMAP_P_H
+#define KOPENINGHOURS_SLOTMAP_P_H
+
+#include <QHash>
+
+#include <cstddef>
+#include <vector>
+
+namespace KOpeningHours {
+
+/** Maps application-defined entry ids to densely numbered slots, reusing the slots of removed entries.
+ *  Data derived from an entry (e.g. index buckets or heap items) refers to the slot and to the
+ *  generation of the slot at the time it was created. Replacing or removing an entry increments
+ *  the generation, which makes all such items stale without having to find them. Stale items
+ *  should be removed once there are more of those than of live ones, see needsCompaction().
+ */
+template <typename T>
+class SlotMap
+{
+public:
+    using Id = quint64;
+    struct Slot {
+        T value = {};
+        Id id = 0;
+        std::size_t itemCount = 0; // live items referring to this slot
+        quint32 generation = 0;
+        bool used = false;
+    };
+
+    /** Returns the slot for entry @p id, invalidating all items of a previous entry with the same id. */
+    quint32 insert(Id id)
+    {
+        quint32 slot;
+        const auto it = m_slotById.constFind(id);
+        if (it != m_slotById.constEnd()) {
+            slot = it.value();
+            retire(slot);
+        } else if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+            m_slotById.insert(id, slot);
+        } else {
+            slot = static_cast<quint32>(m_slots.size());
+            m_slots.emplace_back();
+            m_slotById.insert(id, slot);
+        }
+
+        auto &s = m_slots[slot];
+        s.id = id;
+        s.used = true;
+        return slot;
+    }
+
+    /** Removes entry @p id, returns @c false if there is no such entry. */
+    bool remove(Id id)
+    {
+        const auto it = m_slotById.find(id);
+        if (it == m_slotById.end()) {
+            return false;
+        }
+
+        const auto slot = it.value();
+        m_slotById.erase(it);
+        retire(slot);
+        m_slots[slot].value = {};
+        m_slots[slot].used = false;
+        m_freeSlots.push_back(slot);
+        return true;
+    }
+
+    void clear()
+    {
+        m_slots.clear();
+        m_freeSlots.clear();
+        m_slotById.clear();
+        m_liveItems = 0;
+        m_staleItems = 0;
+    }
+
+    inline bool contains(Id id) const { return m_slotById.contains(id); }
+    inline std::size_t size() const { return m_slotById.size(); }
+    /** The slot of entry @p id, @c nullptr if there is no such entry. */
+    inline const Slot* find(Id id) const
+    {
+        const auto it = m_slotById.constFind(id);
+        return it != m_slotById.constEnd() ? &m_slots[it.value()] : nullptr;
+    }
+
+    /** Amount of slots, including unused ones. */
+    inline quint32 slotCount() const { return static_cast<quint32>(m_slots.size()); }
+    inline Slot& operator[](quint32 slot) { return m_slots[slot]; }
+    inline const Slot& operator[](quint32 slot) const { return m_slots[slot]; }
+    /** Returns @c true if an item created for @p generation of @p slot is still valid. */
+    inline bool isLive(quint32 slot, quint32 generation) const { return m_slots[slot].generation == generation; }
+
+    /** Registers @p count new items for the current generation of @p slot. */
+    inline void addItems(quint32 slot, std::size_t count)
+    {
+        m_slots[slot].itemCount += count;
+        m_liveItems += count;
+    }
+    /** Unregisters @p count live items of @p slot which have been removed. */
+    inline void removeItems(quint32 slot, std::size_t count)
+    {
+        m_slots[slot].itemCount -= count;
+        m_liveItems -= count;
+    }
+    /** Unregisters @p count stale items which have been removed. */
+    inline void removeStaleItems(std::size_t count) { m_staleItems -= count; }
+    /** Unregisters all items, after all derived data has been discarded. */
+    void resetItems()
+    {
+        for (auto &s : m_slots) {
+            s.itemCount = 0;
+        }
+        m_liveItems = 0;
+        m_staleItems = 0;
+    }
+
+    /** Returns @c true if it's worth removing all stale items now. */
+    inline bool needsCompaction() const { return m_staleItems >= MinimumCompactionSize && m_staleItems >= m_liveItems; }
+    /** Call after all stale items have been removed. */
+    inline void compacted() { m_staleItems = 0; }
+
+private:
+    // below this, skipping stale items is cheaper than removing them
+    enum { MinimumCompactionSize = 1024 };
+
+    void retire(quint32 slot)
+    {
+        auto &s = m_slots[slot];
+        ++s.generation;
+        m_liveItems -= s.itemCount;
+        m_staleItems += s.itemCount;
+        s.itemCount = 0;
+    }
+
+    std::vector<Slot> m_slots;
+    std::vector<quint32> m_freeSlots;
+    QHash<Id, quint32> m_slotById;
+    std::size_t m_liveItems = 0;
+    std::size_t m_staleItems = 0;
+};
+
+}
+
+#endif // KOPENINGHOURS_SLOTMAP_P_H
@@ -0,0 +1,124 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "statistics.h"
+#include "statistics_p.h"
+
+#ifdef KOPENINGHOURS_STATISTICS
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QThread>
+#endif
+
+using namespace KOpeningHours;
+
+#ifdef KOPENINGHOURS_STATISTICS
+namespace KOpeningHours {
+Q_LOGGING_CATEGORY(TraceLog, "org.kde.kopeninghours.trace", QtWarningMsg)
+}
+
+namespace {
+struct StatisticsData {
+    std::atomic<quint64> counters[StatisticsCollector::CounterCount];
+    std::atomic<quint64> evaluationTimes[Statistics::EvaluationTimeBucketCount];
+    std::atomic<int> maxRecursionDepth;
+};
+}
+
+static StatisticsData& statisticsData()
+{
+    static StatisticsData s_data;
+    return s_data;
+}
+
+std::atomic<quint64>* StatisticsCollector::counters()
+{
+    return statisticsData().counters;
+}
+
+void StatisticsCollector::recordRecursionDepth(int depth)
+{
+    auto &maxDepth = statisticsData().maxRecursionDepth;
+    auto current = maxDepth.load(std::memory_order_relaxed);
+    while (depth > current && !maxDepth.compare_exchange_weak(current, depth, std::memory_order_relaxed)) {}
+}
+
+void StatisticsCollector::recordEvaluation(qint64 begin, qint64 duration)
+{
+    auto &data = statisticsData();
+    data.counters[EvaluationCount].fetch_add(1, std::memory_order_relaxed);
+
+    // bucket k covers [2^(k-1), 2^k) microseconds
+    auto bucket = 0;
+    for (auto us = duration / 1000; us > 0 && bucket < Statistics::EvaluationTimeBucketCount - 1; us >>= 1) {
+        ++bucket;
+    }
+    data.evaluationTimes[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    if (TraceLog().isDebugEnabled()) {
+        qCDebug(TraceLog, "{\"name\":\"interval\",\"cat\":\"kopeninghours\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":%lld,\"tid\":%llu}",
+                static_cast<long long>(begin / 1000), static_cast<long long>(duration / 1000),
+                static_cast<long long>(QCoreApplication::applicationPid()),
+                static_cast<unsigned long long>(reinterpret_cast<quintptr>(QThread::currentThreadId())));
+    }
+}
+
+const QElapsedTimer& StatisticsCollector::EvaluationSpan::clock()
+{
+    static const QElapsedTimer s_clock = []() {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return s_clock;
+}
+#endif
+
+bool Statistics::isEnabled()
+{
+#ifdef KOPENINGHOURS_STATISTICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+Statistics Statistics::snapshot()
+{
+    Statistics stats;
+#ifdef KOPENINGHOURS_STATISTICS
+    using namespace StatisticsCollector;
+    const auto &data = statisticsData();
+    const auto counter = [&data](Counter c) { return data.counters[c].load(std::memory_order_relaxed); };
+    stats.evaluationCount = counter(EvaluationCount);
+    for (int i = 0; i < EvaluationTimeBucketCount; ++i) {
+        stats.evaluationTimes[i] = data.evaluationTimes[i].load(std::memory_order_relaxed);
+    }
+    stats.ruleEvaluationCount = counter(RuleEvaluationCount);
+    stats.maxRecursionDepth = data.maxRecursionDepth.load(std::memory_order_relaxed);
+    stats.recursionLimitCount = counter(RecursionLimitCount);
+    stats.holidayCacheHits = counter(HolidayCacheHits);
+    stats.holidayCacheMisses = counter(HolidayCacheMisses);
+    stats.holidayCacheRefills = counter(HolidayCacheRefills);
+    stats.sunEventComputations = counter(SunEventComputations);
+    stats.parserRestartCount = counter(ParserRestartCount);
+#endif
+    return stats;
+}
+
+void Statistics::reset()
+{
+#ifdef KOPENINGHOURS_STATISTICS
+    auto &data = statisticsData();
+    for (auto &c : data.counters) {
+        c.store(0, std::memory_order_relaxed);
+    }
+    for (auto &c : data.evaluationTimes) {
+        c.store(0, std::memory_order_relaxed);
+    }
+    data.maxRecursionDepth.store(0, std::memory_order_relaxed);
+#endif
+}
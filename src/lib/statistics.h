@@ -0,0 +1,54 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_STATISTICS_H
+#define KOPENINGHOURS_STATISTICS_H
+
+#include "kopeninghours_export.h"
+
+#include <QtGlobal>
+
+namespace KOpeningHours {
+
+/** Process-wide counters about what the library spends its time on.
+ *  Collecting these is opt-in at build time (the @c ENABLE_STATISTICS CMake option), without that
+ *  all counters stay at zero and the instrumentation has no runtime cost.
+ *
+ *  With statistics enabled, the duration of every evaluation is additionally emitted as
+ *  a trace event in the Chrome/Perfetto JSON trace event format to the debug output of the
+ *  @c org.kde.kopeninghours.trace logging category, if that category is enabled.
+ *
+ *  For per-expression parsing costs see OpeningHours::parseStatistics().
+ */
+struct KOPENINGHOURS_EXPORT Statistics {
+    enum { EvaluationTimeBucketCount = 16 };
+
+    quint64 evaluationCount = 0; ///< Number of OpeningHours::interval() calls, including those done by other evaluation methods.
+    /** Histogram of the evaluation times of OpeningHours::interval() calls.
+     *  Bucket 0 counts calls taking less than 1µs, bucket @c k counts calls taking
+     *  from 2<sup>k-1</sup>µs up to 2<sup>k</sup>µs, the last bucket counts all longer calls.
+     */
+    quint64 evaluationTimes[EvaluationTimeBucketCount] = {};
+    quint64 ruleEvaluationCount = 0; ///< Number of top-level rule evaluations.
+    int maxRecursionDepth = 0; ///< Deepest recursion seen for evaluating a single rule.
+    quint64 recursionLimitCount = 0; ///< Number of rule evaluations aborted due to hitting the recursion limit.
+    quint64 holidayCacheHits = 0; ///< Holiday lookups answered by the holiday cache.
+    quint64 holidayCacheMisses = 0; ///< Holiday lookups that needed to extend the holiday cache.
+    quint64 holidayCacheRefills = 0; ///< Number of times holidays were loaded from KHolidays.
+    quint64 sunEventComputations = 0; ///< Number of computed sunrise, sunset, dawn or dusk times.
+    quint64 parserRestartCount = 0; ///< Parser restarts for error recovery in OpeningHours::setExpression().
+
+    /** Returns @c true if the library has been built with statistics collection. */
+    static bool isEnabled();
+    /** Returns the current value of all counters. This is thread-safe. */
+    static Statistics snapshot();
+    /** Resets all counters to zero. */
+    static void reset();
+};
+
+}
+
+#endif // KOPENINGHOURS_STATISTICS_H
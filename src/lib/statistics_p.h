@@ -0,0 +1,103 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_STATISTICS_P_H
+#define KOPENINGHOURS_STATISTICS_P_H
+
+#include "statistics.h"
+
+#ifdef KOPENINGHOURS_STATISTICS
+#include <QElapsedTimer>
+
+#include <atomic>
+#endif
+
+namespace KOpeningHours {
+
+/** Instrumentation points for Statistics.
+ *  Everything in here compiles to nothing unless KOPENINGHOURS_STATISTICS is defined.
+ */
+namespace StatisticsCollector
+{
+    enum Counter {
+        EvaluationCount,
+        RuleEvaluationCount,
+        RecursionLimitCount,
+        HolidayCacheHits,
+        HolidayCacheMisses,
+        HolidayCacheRefills,
+        SunEventComputations,
+        ParserRestartCount,
+        CounterCount
+    };
+
+#ifdef KOPENINGHOURS_STATISTICS
+    std::atomic<quint64>* counters();
+    void recordRecursionDepth(int depth);
+    void recordEvaluation(qint64 begin, qint64 duration);
+#endif
+
+    inline void increment(Counter counter)
+    {
+#ifdef KOPENINGHOURS_STATISTICS
+        counters()[counter].fetch_add(1, std::memory_order_relaxed);
+#else
+        Q_UNUSED(counter);
+#endif
+    }
+
+    inline void recursionDepth(int depth)
+    {
+#ifdef KOPENINGHOURS_STATISTICS
+        recordRecursionDepth(depth);
+#else
+        Q_UNUSED(depth);
+#endif
+    }
+
+    /** Measures the evaluation time for the lifetime of this object. */
+    class EvaluationSpan
+    {
+    public:
+#ifdef KOPENINGHOURS_STATISTICS
+        inline EvaluationSpan()
+            : m_begin(clock().nsecsElapsed())
+        {
+        }
+        inline ~EvaluationSpan()
+        {
+            recordEvaluation(m_begin, clock().nsecsElapsed() - m_begin);
+        }
+
+    private:
+        /** Process-wide reference time, so trace events of different threads line up. */
+        static const QElapsedTimer& clock();
+        qint64 m_begin;
+#else
+        inline EvaluationSpan() {} // not trivial, to avoid unused variable warnings
+#endif
+    };
+
+    /** Measures the time since its creation, always zero with statistics disabled. */
+    class ElapsedTimer
+    {
+    public:
+#ifdef KOPENINGHOURS_STATISTICS
+        inline ElapsedTimer() { m_timer.start(); }
+        inline qint64 nsecsElapsed() const { return m_timer.nsecsElapsed(); }
+
+    private:
+        QElapsedTimer m_timer;
+#else
+        inline ElapsedTimer() {}
+        inline qint64 nsecsElapsed() const { return 0; }
+#endif
+    };
+}
+
+}
+
+#endif // KOPENINGHOURS_STATISTICS_P_H
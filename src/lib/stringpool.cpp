@@ -0,0 +1,64 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "stringpool_p.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+
+#include <vector>
+
+using namespace KOpeningHours;
+
+namespace {
+struct StringPoolData {
+    QReadWriteLock lock;
+    QHash<QString, StringPool::Id> ids;
+    std::vector<QString> strings{ QString() };
+};
+}
+
+static StringPoolData& stringPool()
+{
+    static StringPoolData s_pool;
+    return s_pool;
+}
+
+StringPool::Id StringPool::intern(const QString &str)
+{
+    if (str.isEmpty()) {
+        return 0;
+    }
+
+    auto &pool = stringPool();
+    {
+        QReadLocker locker(&pool.lock);
+        const auto it = pool.ids.constFind(str);
+        if (it != pool.ids.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QWriteLocker locker(&pool.lock);
+    const auto it = pool.ids.constFind(str);
+    if (it != pool.ids.constEnd()) {
+        return it.value();
+    }
+    const auto id = static_cast<Id>(pool.strings.size());
+    pool.strings.push_back(str);
+    pool.ids.insert(str, id);
+    return id;
+}
+
+QString StringPool::string(Id id)
+{
+    if (id == 0) {
+        return {};
+    }
+    auto &pool = stringPool();
+    QReadLocker locker(&pool.lock);
+    return id < pool.strings.size() ? pool.strings[id] : QString();
+}
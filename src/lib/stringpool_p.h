@@ -0,0 +1,34 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_STRINGPOOL_P_H
+#define KOPENINGHOURS_STRINGPOOL_P_H
+
+#include <QString>
+
+namespace KOpeningHours {
+
+/** Process-wide pool of holiday names.
+ *  Evaluation passes small integer ids around instead of QString copies, and only
+ *  resolves them when the final Interval is created.
+ *  Strings are never removed from the pool, so ids stay valid for the lifetime of the process.
+ *  This is only meant for the bounded set of names from the holiday data, comments of
+ *  expressions are kept per expression in OpeningHoursPrivate instead. This is thread-safe.
+ */
+namespace StringPool
+{
+    /** Identifier of a pooled string, 0 is the empty string. */
+    using Id = quint32;
+
+    /** Returns the id of @p str, adding it to the pool if necessary. */
+    Id intern(const QString &str);
+    /** Returns the string for @p id. */
+    QString string(Id id);
+}
+
+}
+
+#endif // KOPENINGHOURS_STRINGPOOL_P_H
@@ -0,0 +1,66 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "threadpool_p.h"
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include <algorithm>
+
+using namespace KOpeningHours;
+
+namespace {
+class ChunkJob : public QRunnable
+{
+public:
+    void run() override
+    {
+        (*func)(offset, count);
+        done->release();
+    }
+
+    const std::function<void(std::size_t, std::size_t)> *func;
+    std::size_t offset;
+    std::size_t count;
+    QSemaphore *done;
+};
+}
+
+void ThreadPool::forEachChunk(std::size_t count, std::size_t minimumChunkSize, const std::function<void(std::size_t, std::size_t)> &func)
+{
+    auto pool = QThreadPool::globalInstance();
+    const auto jobCount = std::min<std::size_t>(std::max(pool->maxThreadCount(), 1), count / std::max<std::size_t>(minimumChunkSize, 1));
+    if (jobCount <= 1) {
+        if (count > 0) {
+            func(0, count);
+        }
+        return;
+    }
+
+    // the first chunk is processed on the calling thread, the rest is handed to the thread pool
+    // if the pool has no free threads left (e.g. because we are called from within the pool), we
+    // process the chunk right away instead, to avoid waiting on ourselves
+    const auto chunkSize = (count + jobCount - 1) / jobCount;
+    QSemaphore done;
+    int jobs = 0;
+    for (auto offset = chunkSize; offset < count; offset += chunkSize) {
+        auto job = new ChunkJob;
+        job->func = &func;
+        job->offset = offset;
+        job->count = std::min(chunkSize, count - offset);
+        job->done = &done;
+        ++jobs;
+        if (!pool->tryStart(job)) {
+            job->run();
+            delete job;
+        }
+    }
+
+    func(0, std::min(chunkSize, count));
+    done.acquire(jobs);
+}
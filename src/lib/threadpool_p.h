@@ -0,0 +1,27 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_THREADPOOL_P_H
+#define KOPENINGHOURS_THREADPOOL_P_H
+
+#include <cstddef>
+#include <functional>
+
+namespace KOpeningHours {
+
+/** Distribution of independent work items across the global thread pool. */
+namespace ThreadPool
+{
+    /** Calls @p func for consecutive chunks covering the items from 0 to @p count, and returns once all of them are done.
+     *  @p func receives the offset and size of its chunk, and can be called concurrently from different threads.
+     *  Ranges smaller than two times @p minimumChunkSize are processed on the calling thread in a single chunk.
+     */
+    void forEachChunk(std::size_t count, std::size_t minimumChunkSize, const std::function<void(std::size_t offset, std::size_t count)> &func);
+}
+
+}
+
+#endif // KOPENINGHOURS_THREADPOOL_P_H
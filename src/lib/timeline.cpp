@@ -0,0 +1,107 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "timeline_p.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace KOpeningHours;
+
+static constexpr qint64 OpenBegin = std::numeric_limits<qint64>::min();
+static constexpr qint64 OpenEnd = std::numeric_limits<qint64>::max();
+
+Interval Timeline::interval(const QDateTime &dt) const
+{
+    const auto msecs = dt.toMSecsSinceEpoch();
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), msecs, [](const Entry &entry, qint64 msecs) {
+        return entry.end < msecs;
+    });
+    // zero-length open end time intervals only contain their begin, so there can be two candidates
+    for (; it != m_entries.end() && (*it).begin <= msecs; ++it) {
+        if (msecs < (*it).end || ((*it).openEndTime && (*it).begin == (*it).end)) {
+            return toInterval(*it);
+        }
+    }
+    return {};
+}
+
+bool Timeline::intervals(const QDateTime &from, const QDateTime &to, std::vector<Interval> &result) const
+{
+    const auto fromMsecs = from.toMSecsSinceEpoch();
+    const auto toMsecs = to.toMSecsSinceEpoch();
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), fromMsecs, [](const Entry &entry, qint64 msecs) {
+        return entry.end < msecs;
+    });
+    for (; it != m_entries.end() && (*it).begin <= fromMsecs; ++it) {
+        if (fromMsecs < (*it).end || ((*it).openEndTime && (*it).begin == (*it).end)) {
+            break;
+        }
+    }
+    if (it == m_entries.end() || (*it).begin > fromMsecs) {
+        return false;
+    }
+
+    for (; it != m_entries.end(); ++it) {
+        result.push_back(toInterval(*it));
+        if ((*it).end >= toMsecs) {
+            return true;
+        }
+    }
+    return isComplete;
+}
+
+bool Timeline::canExtendTo(const QDateTime &dt) const
+{
+    if (isComplete || m_entries.empty() || dt.toMSecsSinceEpoch() < m_entries.back().end) {
+        return false;
+    }
+    // don't let far away queries trigger precomputing everything up to them
+    return dt.date() < end.addDays(begin.daysTo(end));
+}
+
+bool Timeline::isEmpty() const
+{
+    return m_entries.empty();
+}
+
+void Timeline::append(const Interval &interval)
+{
+    Entry entry;
+    entry.begin = interval.hasOpenBegin() ? OpenBegin : interval.begin().toMSecsSinceEpoch();
+    entry.end = interval.hasOpenEnd() ? OpenEnd : interval.end().toMSecsSinceEpoch();
+    entry.state = static_cast<uint8_t>(interval.state());
+    entry.openEndTime = interval.hasOpenEndTime();
+
+    const auto comment = interval.comment();
+    const auto it = std::find(m_comments.begin(), m_comments.end(), comment);
+    entry.comment = static_cast<int>(std::distance(m_comments.begin(), it));
+    if (it == m_comments.end()) {
+        m_comments.push_back(comment);
+    }
+
+    m_entries.push_back(entry);
+}
+
+Interval Timeline::lastInterval() const
+{
+    return m_entries.empty() ? Interval() : toInterval(m_entries.back());
+}
+
+Interval Timeline::toInterval(const Entry &entry) const
+{
+    Interval i;
+    if (entry.begin != OpenBegin) {
+        i.setBegin(QDateTime::fromMSecsSinceEpoch(entry.begin));
+    }
+    if (entry.end != OpenEnd) {
+        i.setEnd(QDateTime::fromMSecsSinceEpoch(entry.end));
+    }
+    i.setState(static_cast<Interval::State>(entry.state));
+    i.setOpenEndTime(entry.openEndTime);
+    i.setComment(m_comments[entry.comment]);
+    return i;
+}
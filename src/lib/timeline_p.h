@@ -0,0 +1,59 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_TIMELINE_P_H
+#define KOPENINGHOURS_TIMELINE_P_H
+
+#include "interval.h"
+
+#include <QDate>
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+namespace KOpeningHours {
+
+/** Precomputed sequence of consecutive intervals of an expression.
+ *  @see OpeningHours::precompute()
+ */
+class Timeline
+{
+public:
+    /** Returns the precomputed interval containing @p dt, or an invalid interval if there is none. */
+    Interval interval(const QDateTime &dt) const;
+    /** Appends the precomputed intervals overlapping [@p from, @p to) to @p result, starting with the one containing @p from.
+     *  Returns @c true if that covers the entire range, or if no further intervals exist.
+     */
+    bool intervals(const QDateTime &from, const QDateTime &to, std::vector<Interval> &result) const;
+    /** Checks whether @p dt is close enough after the precomputed range to extend it. */
+    bool canExtendTo(const QDateTime &dt) const;
+
+    bool isEmpty() const;
+    void append(const Interval &interval);
+    Interval lastInterval() const;
+
+    QDate begin;
+    QDate end; // first day not precomputed anymore
+    bool isComplete = false; // no further intervals exist after the last one
+
+private:
+    struct Entry {
+        qint64 begin; // milliseconds since epoch
+        qint64 end;
+        uint8_t state;
+        bool openEndTime;
+        int comment; // index into m_comments
+    };
+    Interval toInterval(const Entry &entry) const;
+
+    std::vector<Entry> m_entries;
+    std::vector<QString> m_comments;
+};
+
+}
+
+#endif // KOPENINGHOURS_TIMELINE_P_H
@@ -0,0 +1,73 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "timezonecache_p.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QReadWriteLock>
+
+#include <algorithm>
+
+using namespace KOpeningHours;
+
+// range covered by the offset tables, anything outside falls back to QTimeZone
+enum { TableBeginYear = 1970, TableEndYear = 2100 };
+
+TimeZoneCache::Table::Table(const QTimeZone &tz)
+    : m_timeZone(tz)
+{
+    const QDateTime begin(QDate(TableBeginYear, 1, 1), QTime(0, 0), Qt::UTC);
+    const QDateTime end(QDate(TableEndYear, 1, 1), QTime(0, 0), Qt::UTC);
+    m_begin = begin.toSecsSinceEpoch();
+    m_end = end.toSecsSinceEpoch();
+
+    m_offsets.push_back(tz.offsetFromUtc(begin));
+    if (tz.hasTransitions()) {
+        for (const auto &transition : tz.transitions(begin, end)) {
+            m_transitions.push_back(transition.atUtc.toSecsSinceEpoch());
+            m_offsets.push_back(transition.offsetFromUtc);
+        }
+    }
+}
+
+int TimeZoneCache::Table::offsetFromUtc(qint64 utcSecs) const
+{
+    if (utcSecs < m_begin || utcSecs >= m_end) {
+        return m_timeZone.offsetFromUtc(QDateTime::fromSecsSinceEpoch(utcSecs, Qt::UTC));
+    }
+    const auto it = std::upper_bound(m_transitions.begin(), m_transitions.end(), utcSecs);
+    return m_offsets[std::distance(m_transitions.begin(), it)];
+}
+
+std::shared_ptr<const TimeZoneCache::Table> TimeZoneCache::lookup(const QTimeZone &tz)
+{
+    static QHash<QByteArray, std::shared_ptr<const Table>> s_tables;
+    static QReadWriteLock s_tablesLock;
+
+    if (!tz.isValid()) {
+        return {};
+    }
+
+    const auto id = tz.id();
+    {
+        QReadLocker locker(&s_tablesLock);
+        const auto it = s_tables.constFind(id);
+        if (it != s_tables.constEnd()) {
+            return it.value();
+        }
+    }
+
+    // computing the table can take a moment, don't block readers of other zones meanwhile
+    auto table = std::make_shared<const Table>(tz);
+    QWriteLocker locker(&s_tablesLock);
+    const auto it = s_tables.constFind(id);
+    if (it != s_tables.constEnd()) {
+        return it.value();
+    }
+    s_tables.insert(id, table);
+    return table;
+}
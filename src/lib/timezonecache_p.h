@@ -0,0 +1,55 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_TIMEZONECACHE_P_H
+#define KOPENINGHOURS_TIMEZONECACHE_P_H
+
+#include "localdatetime_p.h"
+
+#include <QTimeZone>
+
+#include <memory>
+#include <vector>
+
+namespace KOpeningHours {
+
+/** Cache of UTC offset transitions of time zones.
+ *  Converting between UTC and a QTimeZone queries the time zone database every time,
+ *  which is expensive compared to the rest of the evaluation.
+ */
+namespace TimeZoneCache
+{
+    /** Immutable table of the UTC offsets of a time zone. */
+    class Table
+    {
+    public:
+        explicit Table(const QTimeZone &tz);
+
+        /** UTC offset in seconds at @p utcSecs seconds since epoch. */
+        int offsetFromUtc(qint64 utcSecs) const;
+        /** Wall clock time at @p utcSecs seconds since epoch. */
+        inline LocalDateTime toLocal(qint64 utcSecs) const
+        {
+            return LocalDateTime::fromSecsSinceEpoch(utcSecs + offsetFromUtc(utcSecs));
+        }
+
+    private:
+        QTimeZone m_timeZone; // for times outside of the table range
+        qint64 m_begin;
+        qint64 m_end;
+        std::vector<qint64> m_transitions; // UTC seconds since epoch at which the offset changes
+        std::vector<int> m_offsets; // offset before the first transition, followed by the offset after each transition
+    };
+
+    /** Returns the shared offset table of @p tz, or @c nullptr for invalid time zones.
+     *  This is thread-safe.
+     */
+    std::shared_ptr<const Table> lookup(const QTimeZone &tz);
+}
+
+}
+
+#endif // KOPENINGHOURS_TIMEZONECACHE_P_H
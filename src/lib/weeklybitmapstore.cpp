@@ -0,0 +1,195 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "weeklybitmapstore.h"
+#include "batchevaluator.h"
+#include "openinghours.h"
+#include "openinghours_p.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace KOpeningHours;
+
+enum {
+    MinutesPerDay = 24 * 60,
+    WordsPerWeek = (WeeklyBitmapStore::SlotsPerWeek + 63) / 64,
+};
+
+namespace KOpeningHours {
+class WeeklyBitmapStorePrivate
+{
+public:
+    /** Number of words needed for one bit per expression. */
+    inline std::size_t wordCount() const { return (count + 63) / 64; }
+    inline const quint64* slot(int slot) const { return bits.data() + slot * capacity; }
+    void grow();
+    void applyExact(const QDateTime &dt, std::vector<quint64> &result) const;
+
+    // slot-major, capacity words per slot
+    std::vector<quint64> bits;
+    std::size_t capacity = 0;
+    std::size_t count = 0;
+
+    // expressions that need to be evaluated by the rule tree, and their indexes
+    std::vector<quint64> exactMask;
+    std::vector<OpeningHours> exact;
+    std::vector<std::size_t> exactIndexes;
+};
+}
+
+void WeeklyBitmapStorePrivate::grow()
+{
+    // double the capacity, so adding many expressions doesn't need to move the existing data too often
+    const auto newCapacity = std::max<std::size_t>(1, capacity * 2);
+    std::vector<quint64> newBits(newCapacity * WeeklyBitmapStore::SlotsPerWeek, 0);
+    for (int s = 0; s < WeeklyBitmapStore::SlotsPerWeek; ++s) {
+        std::copy(bits.begin() + s * capacity, bits.begin() + (s + 1) * capacity, newBits.begin() + s * newCapacity);
+    }
+    bits = std::move(newBits);
+    capacity = newCapacity;
+    exactMask.resize(capacity, 0);
+}
+
+static int minuteOfWeek(const QDateTime &dt)
+{
+    return (dt.date().dayOfWeek() - 1) * MinutesPerDay + dt.time().hour() * 60 + dt.time().minute();
+}
+
+WeeklyBitmapStore::WeeklyBitmapStore()
+    : d(new WeeklyBitmapStorePrivate)
+{
+}
+
+WeeklyBitmapStore::~WeeklyBitmapStore() = default;
+
+std::size_t WeeklyBitmapStore::add(const OpeningHours &openingHours)
+{
+    const auto index = d->count;
+    if (index == d->capacity * 64) {
+        d->grow();
+    }
+    ++d->count;
+
+    quint64 week[WordsPerWeek] = {};
+    bool needsExact = false;
+    if (openingHours.error() == OpeningHours::NoError) {
+        const auto &oh = openingHours.d;
+        if (oh->m_weeklySchedule.isValid()) {
+            needsExact = !oh->m_weeklySchedule.fillOpenSlots(SlotMinutes, week);
+        } else if (oh->m_rules.size() == 1 && oh->m_rules[0]->selectorCount() == 0 && oh->m_rules[0]->m_wideRangeSelectorComment.isEmpty()) {
+            // 24/7 and equivalent, which the weekly schedule doesn't bother with
+            if (oh->m_rules[0]->state() == Interval::Open) {
+                std::fill(std::begin(week), std::end(week), ~quint64(0));
+            }
+        } else {
+            needsExact = true;
+        }
+    }
+
+    const auto word = index / 64;
+    const auto bit = quint64(1) << (index % 64);
+    if (needsExact) {
+        d->exactMask[word] |= bit;
+        d->exact.push_back(openingHours);
+        d->exactIndexes.push_back(index);
+        return index;
+    }
+    for (int s = 0; s < SlotsPerWeek; ++s) {
+        if ((week[s / 64] >> (s % 64)) & 1) {
+            d->bits[s * d->capacity + word] |= bit;
+        }
+    }
+    return index;
+}
+
+std::size_t WeeklyBitmapStore::size() const
+{
+    return d->count;
+}
+
+void WeeklyBitmapStore::clear()
+{
+    d.reset(new WeeklyBitmapStorePrivate);
+}
+
+bool WeeklyBitmapStore::needsExactEvaluation(std::size_t index) const
+{
+    return index < d->count && isSet(d->exactMask, index);
+}
+
+std::size_t WeeklyBitmapStore::exactEvaluationCount() const
+{
+    return d->exact.size();
+}
+
+void WeeklyBitmapStorePrivate::applyExact(const QDateTime &dt, std::vector<quint64> &result) const
+{
+    const auto results = BatchEvaluator::evaluate(exact, dt, BatchEvaluator::Parallel);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        if (results[i].state == Interval::Open) {
+            result[exactIndexes[i] / 64] |= quint64(1) << (exactIndexes[i] % 64);
+        }
+    }
+}
+
+std::vector<quint64> WeeklyBitmapStore::openAt(const QDateTime &dt) const
+{
+    // nothing is open at an invalid time, and it has no slot
+    if (!dt.isValid()) {
+        return std::vector<quint64>(d->wordCount(), 0);
+    }
+    const auto column = d->slot(minuteOfWeek(dt) / SlotMinutes);
+    std::vector<quint64> result(column, column + d->wordCount());
+    d->applyExact(dt, result);
+    return result;
+}
+
+std::vector<quint64> WeeklyBitmapStore::openDuring(const QDateTime &from, const QDateTime &to) const
+{
+    if (!from.isValid() || !to.isValid()) {
+        return std::vector<quint64>(d->wordCount(), 0);
+    }
+
+    // slot range in wall clock time, like the evaluator
+    const auto fromMinute = minuteOfWeek(from);
+    const auto toTime = to.time();
+    const auto toMinute = (from.date().dayOfWeek() - 1 + from.date().daysTo(to.date())) * MinutesPerDay
+        + toTime.hour() * 60 + toTime.minute() + ((toTime.second() || toTime.msec()) ? 1 : 0);
+    if (to <= from || toMinute <= fromMinute) {
+        return openAt(from);
+    }
+
+    const auto firstSlot = fromMinute / SlotMinutes;
+    const auto slotCount = std::min<qint64>(SlotsPerWeek, (toMinute - 1) / SlotMinutes - firstSlot + 1);
+    const auto words = d->wordCount();
+    std::vector<quint64> result(d->slot(firstSlot), d->slot(firstSlot) + words);
+    for (qint64 i = 1; i < slotCount; ++i) {
+        const auto column = d->slot((firstSlot + i) % SlotsPerWeek);
+        // simple enough for the compiler to vectorize
+        for (std::size_t w = 0; w < words; ++w) {
+            result[w] &= column[w];
+        }
+    }
+
+    std::vector<Interval> intervals;
+    for (std::size_t i = 0; i < d->exact.size(); ++i) {
+        d->exact[i].intervals(from, to, intervals);
+        bool open = !intervals.empty() && intervals.front().contains(from);
+        for (auto it = intervals.begin(); open && it != intervals.end(); ++it) {
+            open = (*it).state() == Interval::Open && (it == intervals.begin() || (*std::prev(it)).end() == (*it).begin());
+        }
+        if (open && !intervals.back().hasOpenEnd() && intervals.back().end() < to) {
+            open = false;
+        }
+        if (open) {
+            result[d->exactIndexes[i] / 64] |= quint64(1) << (d->exactIndexes[i] % 64);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,85 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_WEEKLYBITMAPSTORE_H
+#define KOPENINGHOURS_WEEKLYBITMAPSTORE_H
+
+#include "kopeninghours_export.h"
+
+#include <QtGlobal>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class QDateTime;
+
+namespace KOpeningHours {
+
+class OpeningHours;
+class WeeklyBitmapStorePrivate;
+
+/** Columnar store of the weekly open times of many opening hours expressions.
+ *  Expressions repeating identically every week and changing state only at quarter-hour
+ *  boundaries (the vast majority in practice) are stored as one bit per quarter hour of the week.
+ *  Bits of all expressions for the same quarter hour are stored next to each other, which
+ *  turns checking which expressions are open at a given time or during a given time range
+ *  into a simple scan over a few machine words per 64 expressions.
+ *  All other expressions are flagged and evaluated with OpeningHours::interval() as usual.
+ *
+ *  Results are bit masks in which bit @c i % 64 of element @c i / 64 is set if the
+ *  expression with index @c i is open, see isSet().
+ *  The query methods of this class are thread-safe.
+ */
+class KOPENINGHOURS_EXPORT WeeklyBitmapStore
+{
+public:
+    enum {
+        SlotMinutes = 15, ///< Resolution of the stored weekly bitmaps.
+        SlotsPerWeek = 7 * 24 * 60 / SlotMinutes, ///< Bits per stored expression.
+    };
+
+    WeeklyBitmapStore();
+    ~WeeklyBitmapStore();
+
+    /** Adds @p openingHours to the store, and returns its index.
+     *  Invalid expressions are never considered open.
+     */
+    std::size_t add(const OpeningHours &openingHours);
+    /** Amount of expressions in this store. */
+    std::size_t size() const;
+    /** Removes all expressions from this store. */
+    void clear();
+
+    /** Returns @c true if the expression at @p index couldn't be stored as weekly bitmap. */
+    bool needsExactEvaluation(std::size_t index) const;
+    /** Amount of expressions that couldn't be stored as weekly bitmap. */
+    std::size_t exactEvaluationCount() const;
+
+    /** Bit mask of all expressions that are open at @p dt.
+     *  For an invalid @p dt no expression is open.
+     */
+    std::vector<quint64> openAt(const QDateTime &dt) const;
+    /** Bit mask of all expressions that are open during the entire time from @p from until @p to.
+     *  If @p to isn't after @p from, this is the same as openAt(@p from).
+     *  If either of them is invalid, no expression is open.
+     */
+    std::vector<quint64> openDuring(const QDateTime &from, const QDateTime &to) const;
+
+    /** Checks whether the bit for @p index is set in @p mask. */
+    static inline bool isSet(const std::vector<quint64> &mask, std::size_t index)
+    {
+        return (mask[index / 64] >> (index % 64)) & 1;
+    }
+
+private:
+    Q_DISABLE_COPY(WeeklyBitmapStore)
+    std::unique_ptr<WeeklyBitmapStorePrivate> d;
+};
+
+}
+
+#endif // KOPENINGHOURS_WEEKLYBITMAPSTORE_H
@@ -0,0 +1,207 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "weeklyschedule_p.h"
+#include "rule_p.h"
+
+#include <QDateTime>
+
+#include <algorithm>
+
+using namespace KOpeningHours;
+
+enum {
+    MinutesPerDay = 24 * 60,
+    AllDays = 0x7f,
+};
+
+static bool isSimpleWeekdayRange(const WeekdayRange *w)
+{
+    return w->beginDay >= 1 && w->beginDay <= w->endDay && w->endDay <= 7
+        && !w->nthSequence && w->offset == 0 && w->holiday == WeekdayRange::NoHoliday
+        && !w->lhsAndSelector && !w->rhsAndSelector;
+}
+
+static int minuteOfDay(Time t)
+{
+    return t.hour * 60 + t.minute;
+}
+
+/** Fixed time span not extending beyond the end of its day. */
+static bool isSimpleTimespan(const Timespan *t)
+{
+    return t->begin.event == Time::NoEvent && t->end.event == Time::NoEvent
+        && t->interval == 0 && !t->openEnd && !t->pointInTime
+        && t->begin.hour >= 0 && t->begin.minute >= 0 && t->begin.minute < 60 && t->end.minute >= 0 && t->end.minute < 60
+        && minuteOfDay(t->begin) < minuteOfDay(t->end) && minuteOfDay(t->end) <= MinutesPerDay;
+}
+
+/** Bit mask of the days @p rule applies to, or 0 if @p rule cannot be compiled. */
+static uint8_t ruleDays(const Rule *rule)
+{
+    if (rule->m_ruleType != Rule::NormalRule || rule->m_yearSelector || rule->m_monthdaySelector || rule->m_weekSelector) {
+        return 0;
+    }
+    // 24/7 isn't worth the effort
+    if (!rule->m_weekdaySelector && !rule->m_timeSelector) {
+        return 0;
+    }
+    for (auto t = rule->m_timeSelector; t; t = t->next) {
+        if (!isSimpleTimespan(t)) {
+            return 0;
+        }
+    }
+    if (!rule->m_weekdaySelector) {
+        return AllDays;
+    }
+
+    uint8_t days = 0;
+    for (auto w = rule->m_weekdaySelector; w; w = w->next) {
+        if (!isSimpleWeekdayRange(w)) {
+            return 0;
+        }
+        const uint8_t mask = ((1 << (w->endDay - w->beginDay + 1)) - 1) << (w->beginDay - 1);
+        if (days & mask) {
+            return 0;
+        }
+        days |= mask;
+    }
+    return days;
+}
+
+WeeklySchedule WeeklySchedule::compile(const std::vector<Rule*> &rules)
+{
+    // The rule tree evaluator lets a rule replace all preceding rules on the days it applies to,
+    // that's only possible to express here if open rules don't overlap with each other. Closed
+    // rules don't have any effect in that case as long as they don't overlap with open rules.
+    WeeklySchedule schedule;
+    uint8_t openDays = 0;
+    uint8_t closedDays = 0;
+    for (const auto &rule : rules) {
+        const auto days = ruleDays(rule);
+        if (days == 0) {
+            return {};
+        }
+        if (rule->state() == Interval::Closed) {
+            closedDays |= days;
+            continue;
+        }
+        if (openDays & days) {
+            return {};
+        }
+        schedule.addRule(rule, days);
+        if (openDays) {
+            schedule.m_overrideDays |= days;
+        }
+        openDays |= days;
+    }
+    if (openDays & closedDays) {
+        return {};
+    }
+
+    std::sort(schedule.m_entries.begin(), schedule.m_entries.end(), [](const Entry &lhs, const Entry &rhs) {
+        return lhs.begin < rhs.begin;
+    });
+    for (auto it = schedule.m_entries.begin(); it != schedule.m_entries.end() && std::next(it) != schedule.m_entries.end(); ++it) {
+        if ((*it).end > (*std::next(it)).begin) {
+            return {};
+        }
+    }
+    return schedule;
+}
+
+void WeeklySchedule::addRule(const Rule *rule, uint8_t days)
+{
+    const auto state = static_cast<uint8_t>(rule->state());
+    const auto comment = commentIndex(rule->m_comment);
+
+    if (!rule->m_timeSelector) {
+        for (auto w = rule->m_weekdaySelector; w; w = w->next) {
+            m_entries.push_back({ static_cast<uint16_t>((w->beginDay - 1) * MinutesPerDay), static_cast<uint16_t>(w->endDay * MinutesPerDay), state, comment });
+        }
+        return;
+    }
+
+    for (int day = 0; day < 7; ++day) {
+        if ((days & (1 << day)) == 0) {
+            continue;
+        }
+        for (auto t = rule->m_timeSelector; t; t = t->next) {
+            m_entries.push_back({ static_cast<uint16_t>(day * MinutesPerDay + minuteOfDay(t->begin)), static_cast<uint16_t>(day * MinutesPerDay + minuteOfDay(t->end)), state, comment });
+        }
+    }
+}
+
+uint16_t WeeklySchedule::commentIndex(const QString &comment)
+{
+    const auto it = std::find(m_comments.begin(), m_comments.end(), comment);
+    if (it != m_comments.end()) {
+        return static_cast<uint16_t>(std::distance(m_comments.begin(), it));
+    }
+    m_comments.push_back(comment);
+    return static_cast<uint16_t>(m_comments.size() - 1);
+}
+
+bool WeeklySchedule::isValid() const
+{
+    return !m_entries.empty();
+}
+
+bool WeeklySchedule::fillOpenSlots(int slotMinutes, uint64_t *bits) const
+{
+    for (const auto &entry : m_entries) {
+        if (entry.state != Interval::Open) {
+            continue;
+        }
+        if (entry.begin % slotMinutes || entry.end % slotMinutes) {
+            return false;
+        }
+        for (int slot = entry.begin / slotMinutes; slot < entry.end / slotMinutes; ++slot) {
+            bits[slot / 64] |= uint64_t(1) << (slot % 64);
+        }
+    }
+    return true;
+}
+
+Interval WeeklySchedule::interval(const QDateTime &dt) const
+{
+    const auto date = dt.date();
+    const auto dayOfWeek = date.dayOfWeek() - 1;
+    const auto minute = dayOfWeek * MinutesPerDay + dt.time().hour() * 60 + dt.time().minute();
+
+    // first interval not ending before dt, possibly in the next week
+    auto it = std::upper_bound(m_entries.begin(), m_entries.end(), minute, [](int m, const Entry &entry) {
+        return m < entry.end;
+    });
+    int weekOffset = 0;
+    if (it == m_entries.end()) {
+        it = m_entries.begin();
+        weekOffset = 7;
+    }
+    const auto toDateTime = [&](int m) {
+        return QDateTime(date.addDays(weekOffset + m / MinutesPerDay - dayOfWeek), QTime((m % MinutesPerDay) / 60, m % 60));
+    };
+
+    Interval i;
+    if (weekOffset == 0 && (*it).begin <= minute) {
+        i.setBegin(toDateTime((*it).begin));
+        i.setEnd(toDateTime((*it).end));
+        i.setState(static_cast<Interval::State>((*it).state));
+        i.setComment(m_comments[(*it).comment]);
+        return i;
+    }
+
+    i.setState(Interval::Closed);
+    if ((m_overrideDays & (1 << dayOfWeek)) && (weekOffset > 0 || (*it).begin >= (dayOfWeek + 1) * MinutesPerDay)) {
+        // the rule applying today has nothing left for today, which closes the rest of the day
+        i.setBegin(QDateTime(date, {dt.time().hour(), dt.time().minute()}));
+        i.setEnd(QDateTime(date.addDays(1), {0, 0}));
+    } else {
+        i.setBegin(dt);
+        i.setEnd(toDateTime((*it).begin));
+    }
+    return i;
+}
@@ -0,0 +1,59 @@
+/*
+    SPDX-FileCopyrightText: 2026 KOpeningHours contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KOPENINGHOURS_WEEKLYSCHEDULE_P_H
+#define KOPENINGHOURS_WEEKLYSCHEDULE_P_H
+
+#include "interval.h"
+
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+namespace KOpeningHours {
+
+class Rule;
+
+/** Compiled form of expressions only consisting of fixed weekday and time selectors.
+ *  This is a sorted table of all intervals in a week, which allows evaluating such expressions
+ *  with a binary search rather than recursively evaluating the rule tree. The results are
+ *  identical to those of the rule tree evaluator, expressions that cannot be represented
+ *  like this result in an empty schedule and have to be evaluated by the rule tree.
+ */
+class WeeklySchedule
+{
+public:
+    /** Compiles @p rules, returns an invalid schedule if that isn't possible. */
+    static WeeklySchedule compile(const std::vector<Rule*> &rules);
+
+    bool isValid() const;
+    /** Same semantics as OpeningHours::interval(). */
+    Interval interval(const QDateTime &dt) const;
+    /** Sets the bits of @p bits of all slots of @p slotMinutes minutes length during which this is open.
+     *  @p bits needs to have room for one bit per slot in a week, slots start on Monday 00:00.
+     *  @returns @c false if the open intervals don't align with slot boundaries.
+     */
+    bool fillOpenSlots(int slotMinutes, uint64_t *bits) const;
+
+private:
+    struct Entry {
+        uint16_t begin; // minute of the week, 0 being Monday 00:00
+        uint16_t end;
+        uint8_t state;
+        uint16_t comment; // index into m_comments
+    };
+    void addRule(const Rule *rule, uint8_t days);
+    uint16_t commentIndex(const QString &comment);
+
+    std::vector<Entry> m_entries; // sorted and non-overlapping
+    std::vector<QString> m_comments;
+    uint8_t m_overrideDays = 0; // days on which a later rule replaces preceding rules
+};
+
+}
+
+#endif // KOPENINGHOURS_WEEKLYSCHEDULE_P_H
@@ -9,6 +9,8 @@
 #include <KOpeningHours/OpeningHours>
 
 #include <QCoreApplication>
+#include <QDateTime>
+#include <QFutureWatcher>
 #include <QQmlEngine>
 #include <QQmlExtensionPlugin>
 
@@ -33,6 +35,55 @@ OpeningHours OpeningHoursFactory::parse(const QString &expression, int modes) co
     return OpeningHours(expression.toUtf8(), OpeningHours::Modes(modes));
 }
 
+/** Promise-like wrapper for QFuture results in QML. */
+class PendingResult : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool finished READ isFinished NOTIFY finished)
+    Q_PROPERTY(QVariant result READ result NOTIFY finished)
+public:
+    template <typename T>
+    explicit PendingResult(const QFuture<T> &future)
+    {
+        auto watcher = new QFutureWatcher<T>(this);
+        connect(watcher, &QFutureWatcher<T>::finished, this, [this, watcher]() {
+            m_result = QVariant::fromValue(watcher->result());
+            m_finished = true;
+            Q_EMIT finished();
+        });
+        watcher->setFuture(future);
+    }
+
+    bool isFinished() const { return m_finished; }
+    QVariant result() const { return m_result; }
+
+Q_SIGNALS:
+    void finished();
+
+private:
+    QVariant m_result;
+    bool m_finished = false;
+};
+
+/** Asynchronous evaluation, so delegates don't block the UI. */
+class AsyncEvaluator
+{
+    Q_GADGET
+public:
+    Q_INVOKABLE QObject* interval(const KOpeningHours::OpeningHours &oh, const QDateTime &dt) const;
+    Q_INVOKABLE QObject* currentState(const KOpeningHours::OpeningHours &oh) const;
+};
+
+QObject* AsyncEvaluator::interval(const OpeningHours &oh, const QDateTime &dt) const
+{
+    return new PendingResult(oh.intervalAsync(dt));
+}
+
+QObject* AsyncEvaluator::currentState(const OpeningHours &oh) const
+{
+    return new PendingResult(Display::currentStateAsync(oh));
+}
+
 }
 
 void KOpeningHoursQmlPlugin::registerTypes(const char*)
@@ -45,6 +96,9 @@ void KOpeningHoursQmlPlugin::registerTypes(const char*)
         qmlRegisterSingletonType("org.kde.kopeninghours", 1, 0, "Display", [](QQmlEngine*, QJSEngine *engine) -> QJSValue {
             return engine->toScriptValue(KOpeningHours::Display());
         });
+        qmlRegisterSingletonType("org.kde.kopeninghours", 1, 0, "AsyncEvaluator", [](QQmlEngine*, QJSEngine *engine) -> QJSValue {
+            return engine->toScriptValue(KOpeningHours::AsyncEvaluator());
+        });
     }
 }
 
@@ -119,13 +119,10 @@ int main(int argc, char **argv)
 
     std::cout << qPrintable(Display::currentState(oh)) << std::endl << std::endl;
 
-    auto interval = oh.interval(QDateTime::currentDateTime());
-    printInterval(interval);
-    for (int i = 0; interval.isValid() && i < 20; ++i) {
-        interval = oh.nextInterval(interval);
-        if (interval.isValid()) {
-            printInterval(interval);
-        }
+    OpeningHours::Iterator it(oh, QDateTime::currentDateTime());
+    printInterval(it.interval());
+    for (int i = 0; i < 20 && it.next(); ++i) {
+        printInterval(it.interval());
     }
 
     return 0;
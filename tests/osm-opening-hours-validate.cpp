@@ -8,13 +8,154 @@
 
 #include <QCoreApplication>
 #include <QCommandLineParser>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
 
+#include <algorithm>
 #include <cstring>
+#include <deque>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
 
 using namespace KOpeningHours;
 
+// input is processed in blocks of complete lines of about this size
+enum { BlockSize = 256 * 1024 };
+
+namespace {
+struct ValidationOptions {
+    bool verifyNormalization = false;
+    bool json = false;
+};
+
+struct ValidationResult {
+    int total = 0;
+    int normalized = 0;
+    int simplified = 0;
+    int errors = 0;
+    std::string diagnostics;
+    std::string records;
+
+    ValidationResult &operator+=(const ValidationResult &other)
+    {
+        total += other.total;
+        normalized += other.normalized;
+        simplified += other.simplified;
+        errors += other.errors;
+        return *this;
+    }
+};
+}
+
+static void validateLine(OpeningHours &oh, const char *line, int size, const ValidationOptions &options, ValidationResult &result, std::ostream &diagnostics, std::ostream &records)
+{
+    ++result.total;
+    oh.setExpression(line, size);
+    const auto parseStats = oh.parseStatistics();
+    const auto error = oh.error();
+
+    QJsonObject record;
+    QJsonObject timings;
+    if (options.json) {
+        record.insert(QLatin1String("expression"), QString::fromUtf8(line, size));
+        record.insert(QLatin1String("error"), QLatin1String(QMetaEnum::fromType<OpeningHours::Error>().valueToKey(error)));
+        record.insert(QLatin1String("restarts"), parseStats.restartCount);
+        timings.insert(QLatin1String("parse"), parseStats.parseTime);
+        timings.insert(QLatin1String("autocorrect"), parseStats.autocorrectTime);
+        timings.insert(QLatin1String("validate"), parseStats.validateTime);
+    }
+    const auto writeRecord = [&]() {
+        if (options.json) {
+            record.insert(QLatin1String("timings"), timings);
+            records << QJsonDocument(record).toJson(QJsonDocument::Compact).constData() << '\n';
+        }
+    };
+
+    if (error == OpeningHours::SyntaxError) {
+        diagnostics << "Syntax error: " << QByteArray(line, size).constData() << '\n';
+        ++result.errors;
+        writeRecord();
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const auto n = oh.normalizedExpression();
+    if (options.json) {
+        timings.insert(QLatin1String("normalize"), timer.nsecsElapsed());
+        record.insert(QLatin1String("normalized"), QString::fromUtf8(n));
+    }
+    if (options.verifyNormalization) {
+        oh.setExpression(n);
+        if (oh.error() == OpeningHours::SyntaxError) {
+            diagnostics << "Syntax error in normalized expression! " << QByteArray(line, size).constData() << " normalized: " << n.constData() << '\n';
+        }
+    }
+    if (n.size() != size || std::strncmp(line, n.constData(), size) != 0) {
+        ++result.normalized;
+        diagnostics << "Expression " << QByteArray(line, size).constData() << " normalized to " << n.constData() << '\n';
+    }
+    timer.restart();
+    const auto simplifiedExpr = oh.simplifiedExpression();
+    if (options.json) {
+        timings.insert(QLatin1String("simplify"), timer.nsecsElapsed());
+        record.insert(QLatin1String("simplified"), QString::fromUtf8(simplifiedExpr));
+    }
+    if (n != simplifiedExpr) {
+        ++result.simplified;
+        diagnostics << "Expression " << n.constData() << " simplified to " << simplifiedExpr.constData() << '\n';
+    }
+    writeRecord();
+}
+
+/** Validates all lines in @p block, which must only contain complete lines. */
+static void validateBlock(const QByteArray &block, const ValidationOptions &options, ValidationResult &result)
+{
+    OpeningHours oh;
+    std::ostringstream diagnostics;
+    std::ostringstream records;
+    const char *it = block.constData();
+    const char *end = it + block.size();
+    while (it < end) {
+        auto lineEnd = static_cast<const char*>(std::memchr(it, '\n', end - it));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        if (lineEnd > it) {
+            validateLine(oh, it, lineEnd - it, options, result, diagnostics, records);
+        }
+        it = lineEnd + 1;
+    }
+    result.diagnostics = diagnostics.str();
+    result.records = records.str();
+}
+
+namespace {
+class ValidationJob : public QRunnable
+{
+public:
+    void run() override
+    {
+        validateBlock(block, options, result);
+        done.release();
+    }
+
+    QByteArray block;
+    ValidationOptions options;
+    ValidationResult result;
+    QSemaphore done;
+};
+}
+
 int main(int argc, char **argv)
 {
     QCoreApplication app(argc, argv);
@@ -24,55 +165,79 @@ int main(int argc, char **argv)
 
     QCommandLineOption verifyNormalizationOpt({QStringLiteral("verify-normalization")}, QStringLiteral("verify normalized expression themselves have valid syntax"));
     parser.addOption(verifyNormalizationOpt);
+    QCommandLineOption jobsOpt({QStringLiteral("j"), QStringLiteral("jobs")}, QStringLiteral("number of threads to use when reading from stdin, defaults to the number of CPU cores"), QStringLiteral("jobs"));
+    parser.addOption(jobsOpt);
+    QCommandLineOption jsonOpt({QStringLiteral("json")}, QStringLiteral("write one JSON record per input line to stdout, including per-phase timings in nanoseconds"));
+    parser.addOption(jsonOpt);
     parser.addPositionalArgument(QStringLiteral("expression"), QStringLiteral("OSM opening hours expression, omit for using stdin."));
     parser.process(app);
 
-    const auto verifyNormalization = parser.isSet(verifyNormalizationOpt);
+    ValidationOptions options;
+    options.verifyNormalization = parser.isSet(verifyNormalizationOpt);
+    options.json = parser.isSet(jsonOpt);
     if (parser.positionalArguments().isEmpty()) {
-        OpeningHours oh;
+        const auto jobCount = parser.isSet(jobsOpt) ? std::max(parser.value(jobsOpt).toInt(), 1) : std::max(QThread::idealThreadCount(), 1);
+        QThreadPool pool;
+        pool.setMaxThreadCount(jobCount);
+
         QFile in;
         in.open(stdin, QFile::ReadOnly);
-        int total = 0;
-        int normalized = 0;
-        int simplified = 0;
-        int errors = 0;
-        char line[4096];
+        ValidationResult result;
+
+        // blocks are validated in parallel, but diagnostics are printed in input order
+        // the amount of blocks in flight is limited to bound memory use
+        std::deque<std::unique_ptr<ValidationJob>> jobs;
+        const auto finishJob = [&]() {
+            auto &job = jobs.front();
+            job->done.acquire();
+            std::cout << job->result.records << std::flush;
+            std::cerr << job->result.diagnostics << std::flush;
+            result += job->result;
+            jobs.pop_front();
+        };
+
+        const auto startJob = [&](QByteArray &&block) {
+            auto job = std::make_unique<ValidationJob>();
+            job->setAutoDelete(false);
+            job->block = std::move(block);
+            job->options = options;
+            if (jobCount == 1) {
+                job->run();
+            } else {
+                pool.start(job.get());
+            }
+            jobs.push_back(std::move(job));
+            while (jobs.size() > 2 * static_cast<std::size_t>(jobCount)) {
+                finishJob();
+            }
+        };
+
+        QByteArray remainder;
         while (!in.atEnd()) {
-            auto size = in.readLine(line, sizeof(line));
-            if (size <= 1) {
+            auto block = remainder + in.read(BlockSize);
+            // split after the last line break, lines longer than a block continue in the next one
+            const auto lastLineBreak = block.lastIndexOf('\n');
+            if (lastLineBreak < 0) {
+                remainder = std::move(block);
                 continue;
             }
-            --size; // trailing linebreak
-            ++total;
-            oh.setExpression(line, size);
-            if (oh.error() == OpeningHours::SyntaxError) {
-                std::cerr << "Syntax error: " << QByteArray(line, size).constData() << std::endl;
-                ++errors;
-            } else {
-                const auto n = oh.normalizedExpression();
-                if (verifyNormalization) {
-                    oh.setExpression(n);
-                    if (oh.error() == OpeningHours::SyntaxError) {
-                        std::cerr << "Syntax error in normalized expression! " << QByteArray(line, size).constData() << " normalized: " << n.constData() << std::endl;
-                    }
-                }
-                if (n.size() != size || std::strncmp(line, n.constData(), size) != 0) {
-                    ++normalized;
-                    std::cerr << "Expression " << QByteArray(line, size).constData() << " normalized to " << n.constData() << std::endl;
-                }
-                const auto simplifiedExpr = oh.simplifiedExpression();
-                if (n != simplifiedExpr) {
-                    ++simplified;
-                    std::cerr << "Expression " << n.constData() << " simplified to " << simplifiedExpr.constData() << std::endl;
-                }
-            }
+            remainder = block.mid(lastLineBreak + 1);
+            block.truncate(lastLineBreak + 1);
+            startJob(std::move(block));
+        }
+        // last line without a trailing line break
+        if (!remainder.isEmpty()) {
+            startJob(std::move(remainder));
+        }
+        while (!jobs.empty()) {
+            finishJob();
         }
 
-        std::cerr << total << " expressions checked, "
-                  << errors << " invalid, "
-                  << normalized << " not in normal form, "
-                  << simplified << " can be simplified" << std::endl;
-        return errors;
+        std::cerr << result.total << " expressions checked, "
+                  << result.errors << " invalid, "
+                  << result.normalized << " not in normal form, "
+                  << result.simplified << " can be simplified" << std::endl;
+        return result.errors;
     } else {
         OpeningHours oh(parser.positionalArguments().at(0).toUtf8());
         std::cout << oh.normalizedExpression().constData() << std::endl;